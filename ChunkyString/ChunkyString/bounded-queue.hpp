@@ -0,0 +1,80 @@
+/**
+ * \file bounded-queue.hpp
+ *
+ * \brief Declares BoundedQueue, a fixed-capacity queue for handing work
+ *        from one thread to another.
+ */
+
+#ifndef BOUNDED_QUEUE_HPP_INCLUDED
+#define BOUNDED_QUEUE_HPP_INCLUDED 1
+
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <mutex>
+#include <utility>
+
+/**
+ * \class BoundedQueue
+ * \brief A first-in-first-out queue that holds at most `capacity` items
+ *
+ * \details Producers block in `push` while the queue is full, and
+ *          consumers block in `pop` while it is empty, so a fast stage
+ *          can never get more than `capacity` items ahead of a slow one.
+ *          When the producer is done, it calls `close`; consumers then
+ *          drain what's left, after which `pop` returns false.
+ *
+ * \remarks Header-only because it's a template.
+ */
+template <typename T>
+class BoundedQueue {
+ public:
+  explicit BoundedQueue(size_t capacity) : capacity_(capacity) {
+    // Nothing else to do.
+  }
+
+  BoundedQueue(const BoundedQueue& other) = delete;
+  BoundedQueue& operator=(const BoundedQueue& other) = delete;
+
+  /// Add an item to the back, waiting for room if necessary
+  void push(T item) {
+    std::unique_lock<std::mutex> lock{mutex_};
+    notFull_.wait(lock, [this] { return items_.size() < capacity_; });
+    items_.push_back(std::move(item));
+    notEmpty_.notify_one();
+  }
+
+  /**
+   * \brief Take the item at the front, waiting for one if necessary
+   *
+   * \returns false (leaving `item` alone) if the queue is closed and empty
+   */
+  bool pop(T& item) {
+    std::unique_lock<std::mutex> lock{mutex_};
+    notEmpty_.wait(lock, [this] { return closed_ || !items_.empty(); });
+    if (items_.empty()) {
+      return false;
+    }
+    item = std::move(items_.front());
+    items_.pop_front();
+    notFull_.notify_one();
+    return true;
+  }
+
+  /// Promise that nothing more will be pushed
+  void close() {
+    std::lock_guard<std::mutex> lock{mutex_};
+    closed_ = true;
+    notEmpty_.notify_all();
+  }
+
+ private:
+  size_t capacity_;
+  bool closed_ = false;
+  std::deque<T> items_;
+  std::mutex mutex_;
+  std::condition_variable notFull_;
+  std::condition_variable notEmpty_;
+};
+
+#endif  // BOUNDED_QUEUE_HPP_INCLUDED
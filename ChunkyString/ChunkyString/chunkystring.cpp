@@ -5,7 +5,10 @@
  * \brief Contains implementations of ChunkyString member functions
  */
 
+#include <algorithm>
+#include <cstring>
 #include <iostream>
+#include <stdexcept>
 #include <string>
 
 #include "chunkystring.hpp"
@@ -16,41 +19,66 @@ ChunkyString::ChunkyString() : size_{0}, chunks_{} {
     // nothing left to do
 }
 
+// Arena Constructor: all chunks will be allocated from resource
+ChunkyString::ChunkyString(std::pmr::memory_resource* resource)
+    : size_{0}, chunks_{resource} {
+    // nothing left to do
+}
+
+// string_view Constructor
+ChunkyString::ChunkyString(std::string_view text,
+                           std::pmr::memory_resource* resource)
+    : size_{0}, chunks_{resource} {
+    append(text);
+}
+
 // Copy Constructor
-ChunkyString::ChunkyString(const ChunkyString& other) {
-    chunks_.clear();
-    size_ = 0;
-// Uses push_back to copy each element and increment size (deep copy)
-    if (!other.isEmpty()) {
-        for (ChunkyString::ConstIterator i = other.begin();
-        i != other.end(); ++i) {
-            push_back(*i);
-        }
-    }
+ChunkyString::ChunkyString(const ChunkyString& other)
+    : ChunkyString(other, std::pmr::get_default_resource()) {
+    // nothing left to do
 }
 
 // Assignment operator
 ChunkyString& ChunkyString::operator=(const ChunkyString& other) {
-    chunks_.clear();
-    size_ = 0;
-// Uses push_back to copy each element and increment size (deep copy)
-    if (!other.isEmpty()) {
-        for (ChunkyString::ConstIterator i = other.begin();
-        i != other.end(); ++i) {
-            push_back(*i);
-        }
+    if (this == &other) {
+        return *this;
     }
+    count(&Counters::chunkFrees_, chunks_.size());
+    // copies the chunks as they are, so run chunks stay compressed; the
+    // list keeps its own memory resource
+    chunks_.assign(other.chunks_.begin(), other.chunks_.end());
+    count(&Counters::chunkAllocations_, chunks_.size());
+    size_ = other.size_;
 
     return *this;
 }
 
+// Copy Constructor into a specific memory resource
+ChunkyString::ChunkyString(const ChunkyString& other,
+                           std::pmr::memory_resource* resource)
+    : size_{0}, chunks_{resource} {
+    for (const Chunk& chunk : other.chunks_) {
+        chunks_.push_back(chunk);
+    }
+    count(&Counters::chunkAllocations_, chunks_.size());
+    size_ = other.size_;
+}
+
 // appends a character to the ChunkyString
 void ChunkyString::push_back(char c) {
+    // A run chunk of the same character just gets longer
+    if (size_ != 0 && chunks_.back().run_ && chunks_.back().chars_[0] == c) {
+        ++(chunks_.back().length_);
+        ++size_;
+        return;
+    }
     // If a chunkystring is empty or the last chunk is full, make a new chunk
     // and add the character there
-    if (size_ == 0 || ((chunks_.back().length_) == Chunk::CHUNKSIZE)) {
+    if (size_ == 0 || chunks_.back().run_ ||
+        ((chunks_.back().length_) == Chunk::CHUNKSIZE)) {
         Chunk newChunk;
         chunks_.push_back(newChunk);
+        count(&Counters::chunkAllocations_, 1);
         chunks_.back().chars_[0] = c;
         chunks_.back().length_++;
 
@@ -64,15 +92,97 @@ void ChunkyString::push_back(char c) {
     ++size_;
 }
 
+// appends count copies of c, storing long runs as a single run chunk
+void ChunkyString::appendRun(char c, size_t count) {
+    // extend a run of the same character that ends the string
+    if (size_ != 0 && chunks_.back().run_ && chunks_.back().chars_[0] == c) {
+        chunks_.back().length_ += count;
+        size_ += count;
+    // short runs aren't worth compressing
+    } else if (count <= Chunk::CHUNKSIZE) {
+        for (size_t n = 0; n < count; ++n) {
+            push_back(c);
+        }
+    } else {
+        chunks_.push_back(Chunk{c, count});
+        this->count(&Counters::chunkAllocations_, 1);
+        size_ += count;
+    }
+}
+
+// appends text, topping up the last chunk and then filling whole chunks
+ChunkyString& ChunkyString::append(std::string_view text) {
+    while (!text.empty()) {
+        if (size_ == 0 || chunks_.back().run_ ||
+            chunks_.back().length_ == Chunk::CHUNKSIZE) {
+            chunks_.push_back(Chunk{});
+            count(&Counters::chunkAllocations_, 1);
+        }
+        Chunk& last = chunks_.back();
+        size_t count = std::min(text.size(), Chunk::CHUNKSIZE - last.length_);
+        std::memcpy(last.chars_ + last.length_, text.data(), count);
+        last.length_ += count;
+        size_ += count;
+        text.remove_prefix(count);
+    }
+    return *this;
+}
+
+// copies the characters into a std::string with a single allocation
+std::string ChunkyString::to_string() const {
+    std::string result;
+    result.reserve(size_);
+    for (const Chunk& chunk : chunks_) {
+        if (chunk.run_) {
+            result.append(chunk.length_, chunk.chars_[0]);
+        } else {
+            result.append(chunk.chars_, chunk.length_);
+        }
+    }
+    return result;
+}
+
+// rebuilds the chunk list, turning long runs of characters into run chunks
+void ChunkyString::compact() {
+    ChunkyString packed{resource()};
+    char runChar = '\0';
+    size_t runLength = 0;
+    for (const Chunk& chunk : chunks_) {
+        // a run chunk counts as length_ copies of its one character
+        size_t distinct = chunk.run_ ? 1 : chunk.length_;
+        size_t copies = chunk.run_ ? chunk.length_ : 1;
+        for (size_t n = 0; n < distinct; ++n) {
+            if (runLength > 0 && chunk.chars_[n] == runChar) {
+                runLength += copies;
+            } else {
+                packed.appendRun(runChar, runLength);
+                runChar = chunk.chars_[n];
+                runLength = copies;
+            }
+        }
+    }
+    packed.appendRun(runChar, runLength);
+    replaceChunks(packed);
+}
+
+// Swaps in a rebuilt chunk list, keeping the counters up to date
+void ChunkyString::replaceChunks(ChunkyString& rebuilt) {
+    count(&Counters::chunkFrees_, chunks_.size());
+    count(&Counters::chunkAllocations_, rebuilt.counters().chunkAllocations_);
+    count(&Counters::bytesShifted_, rebuilt.counters().bytesShifted_);
+    chunks_.swap(rebuilt.chunks_);
+    size_ = rebuilt.size_;
+}
+
 // Returns an iterator to the begining of the ChunkyString
 ChunkyString::iterator ChunkyString::begin() {
-    Iterator begin = Iterator{chunks_.begin(), 0};
+    Iterator begin = Iterator{this, chunks_.begin(), 0};
     return begin;
 }
 
 // Returns an iterator to the end of the ChunkyString
 ChunkyString::iterator ChunkyString::end() {
-    return Iterator{chunks_.end(), 0};
+    return Iterator{this, chunks_.end(), 0};
 }
 
 // Returns a Constant iterator to the begining of the ChunkyString
@@ -86,16 +196,86 @@ ChunkyString::const_iterator ChunkyString::cend() const {
     return ConstIterator{chunks_.end(), 0};
 }
 
+// Returns a reverse iterator to the last character
+ChunkyString::reverse_iterator ChunkyString::rbegin() {
+    return reverse_iterator{end()};
+}
+
+// Returns a reverse iterator to "one before the beginning"
+ChunkyString::reverse_iterator ChunkyString::rend() {
+    return reverse_iterator{begin()};
+}
+
+// Returns a constant reverse iterator to the last character
+ChunkyString::const_reverse_iterator ChunkyString::crbegin() const {
+    return const_reverse_iterator{cend()};
+}
+
+// Returns a constant reverse iterator to "one before the beginning"
+ChunkyString::const_reverse_iterator ChunkyString::crend() const {
+    return const_reverse_iterator{cbegin()};
+}
+
+// Walks the chunks from the back, scanning each one from its end
+template <typename ChunkIter>
+std::pair<ChunkIter, size_t> ChunkyString::lastOf(ChunkIter first,
+                                                  ChunkIter last, char c) {
+    for (ChunkIter chunk = last; chunk != first;) {
+        --chunk;
+        if (chunk->run_) {
+            if (chunk->chars_[0] == c) {
+                return {chunk, chunk->length_ - 1};
+            }
+            continue;
+        }
+        for (size_t n = chunk->length_; n > 0; --n) {
+            if (chunk->chars_[n - 1] == c) {
+                return {chunk, n - 1};
+            }
+        }
+    }
+    return {last, 0};
+}
+
+// Returns an iterator to the last c, or end()
+ChunkyString::iterator ChunkyString::rfind(char c) {
+    auto [chunk, index] = lastOf(chunks_.begin(), chunks_.end(), c);
+    return Iterator{this, chunk, index};
+}
+
+// Returns a constant iterator to the last c, or cend()
+ChunkyString::const_iterator ChunkyString::rfind(char c) const {
+    auto [chunk, index] = lastOf(chunks_.cbegin(), chunks_.cend(), c);
+    return ConstIterator{chunk, index};
+}
+
 // Append operator
+// Appends straight from rhs's chunks, keeping run chunks compressed. Only
+// appending a string to itself needs a copy, since the chunks being read
+// would grow; the copy comes from the heap rather than our resource, so an
+// arena doesn't keep it around.
 ChunkyString& ChunkyString::operator+=(const ChunkyString& rhs) {
-    ChunkyString copy = rhs;
-// Makes a deep copy by pushing back each of the elements from rhs
-    for (Iterator i = copy.begin(); i != copy.end(); ++i) {
-        push_back(*i);
+    if (&rhs == this) {
+        ChunkyString copy{rhs, std::pmr::new_delete_resource()};
+        return *this += copy;
+    }
+    for (const Chunk& chunk : rhs.chunks_) {
+        appendPiece(chunk, 0, chunk.length_);
     }
     return *this;
 }
 
+// Appends part of a chunk, copying runs as runs
+void ChunkyString::appendPiece(const Chunk& chunk, size_t first, size_t last) {
+    if (chunk.run_) {
+        appendRun(chunk.chars_[0], last - first);
+    } else {
+        for (size_t n = first; n < last; ++n) {
+            push_back(chunk.chars_[n]);
+        }
+    }
+}
+
 // Equality operator
 bool ChunkyString::operator==(const ChunkyString& rhs) const {
     // Checks that sizes are equivalent first
@@ -122,20 +302,59 @@ bool ChunkyString::operator!=(const ChunkyString& rhs) const {
     return !(*this == rhs);
 }
 
-// Loops through a ChunkyString, adding each element to a printable ostream&
+// Equality with text: compare a chunk at a time against the matching slice
+bool ChunkyString::operator==(std::string_view rhs) const {
+    if (size_ != rhs.size()) {
+        return false;
+    }
+    for (const Chunk& chunk : chunks_) {
+        std::string_view piece = rhs.substr(0, chunk.length_);
+        if (chunk.run_) {
+            if (piece.find_first_not_of(chunk.chars_[0]) !=
+                std::string_view::npos) {
+                return false;
+            }
+        } else if (std::memcmp(chunk.chars_, piece.data(), chunk.length_)) {
+            return false;
+        }
+        rhs.remove_prefix(chunk.length_);
+    }
+    return true;
+}
+
+bool ChunkyString::operator!=(std::string_view rhs) const {
+    return !(*this == rhs);
+}
+
+bool ChunkyString::operator<(std::string_view rhs) const {
+    return std::lexicographical_compare(begin(), end(), rhs.begin(),
+                                        rhs.end());
+}
+
+// Writes a ChunkyString to an ostream& a chunk at a time
 std::ostream& ChunkyString::print(std::ostream& out) const {
-    for (ChunkyString::ConstIterator i = cbegin(); i != cend(); ++i) {
-        out << *i;
+    for (const Chunk& chunk : chunks_) {
+        if (chunk.run_) {
+            for (size_t n = 0; n < chunk.length_; ++n) {
+                out.put(chunk.chars_[0]);
+            }
+        } else {
+            out.write(chunk.chars_, chunk.length_);
+        }
     }
     return out;
 }
 
 std::ostream& ChunkyString::printChunks(std::ostream& out) const {
-    for (std::_List_const_iterator<ChunkyString::Chunk> i = chunks_.cbegin();
+    for (std::pmr::list<Chunk>::const_iterator i = chunks_.cbegin();
     i != chunks_.end(); ++i) {
         out << "Length: " << i->length_ << " - ";
-        for (size_t j = 0; j < i->length_; ++j) {
-            out << i->chars_[j];
+        if (i->run_) {
+            out << i->chars_[0] << " (run)";
+        } else {
+            for (size_t j = 0; j < i->length_; ++j) {
+                out << i->chars_[j];
+            }
         }
         out << std::endl;
     }
@@ -154,15 +373,59 @@ size_t ChunkyString::size() const {
 }
 
 // Default Chunk Constructor
-ChunkyString::Chunk::Chunk() : length_{0} {
+ChunkyString::Chunk::Chunk() : length_{0}, run_{false} {
     // nothing left to do
 }
 
 // 1 Param Chunk Constructor
-ChunkyString::Chunk::Chunk(size_t length) : length_{length} {
+ChunkyString::Chunk::Chunk(size_t length) : length_{length}, run_{false} {
     // nothing left to do
 }
 
+// Run Chunk Constructor: count copies of c
+ChunkyString::Chunk::Chunk(char c, size_t count)
+    : length_{count}, run_{true} {
+    chars_[0] = c;
+    normalize();
+}
+
+// Runs that fit in CHUNKSIZE characters are stored as ordinary chunks
+void ChunkyString::Chunk::normalize() {
+    if (run_ && length_ <= CHUNKSIZE) {
+        for (size_t n = 1; n < length_; ++n) {
+            chars_[n] = chars_[0];
+        }
+        run_ = false;
+    }
+}
+
+// Splits a run chunk in two so that index starts the second half
+std::pmr::list<ChunkyString::Chunk>::iterator ChunkyString::splitRun(
+    std::pmr::list<Chunk>::iterator chunk, size_t index) {
+    if (index == 0) {
+        return chunk;
+    }
+    Chunk rest{chunk->chars_[0], chunk->length_ - index};
+    chunk->length_ = index;
+    chunk->normalize();
+    std::pmr::list<Chunk>::iterator nextChunk = chunk;
+    ++nextChunk;
+    count(&Counters::chunkAllocations_, 1);
+    return chunks_.insert(nextChunk, rest);
+}
+
+// Splits the character off from the run, and then splits the rest of the
+// run again after a chunk's worth, which normalize turns into an ordinary
+// chunk
+std::pmr::list<ChunkyString::Chunk>::iterator ChunkyString::expandRun(
+    std::pmr::list<Chunk>::iterator chunk, size_t index) {
+    chunk = splitRun(chunk, index);
+    if (chunk->run_) {
+        splitRun(chunk, Chunk::CHUNKSIZE);
+    }
+    return chunk;
+}
+
 /*
   Insert a character and return the index of the insertee. If the insertion
   is at the end of a chunk, just push back. Otherwise, if the chunk is full
@@ -173,6 +436,7 @@ ChunkyString::Chunk::Chunk(size_t length) : length_{length} {
   into the correct index. Fix size and return the iterator.
 */
 ChunkyString::Iterator ChunkyString::insert(ChunkyString::Iterator i, char c) {
+    i.settle();
     // if the insertion is at the end, this should be equivalent to a push back
     if (i == end()) {
         push_back(c);
@@ -180,12 +444,31 @@ ChunkyString::Iterator ChunkyString::insert(ChunkyString::Iterator i, char c) {
         --toReturn;
         return toReturn;
     }
+    // Runs absorb copies of their own character. Anything else expands just
+    // the part of the run at the insertion point.
+    if (i.chunkPointer_->run_) {
+        if (i.chunkPointer_->chars_[0] == c) {
+            ++(i.chunkPointer_->length_);
+            ++size_;
+            return i;
+        }
+        i = iterator{this, splitRun(i.chunkPointer_, i.index_), 0};
+        if (i.chunkPointer_->run_) {
+            // the rest of the run stays compressed; c gets its own chunk
+            ++size_;
+            count(&Counters::chunkAllocations_, 1);
+            return iterator{this, chunks_.insert(i.chunkPointer_, Chunk{c, 1}),
+                            0};
+        }
+    }
     // If the chunk is full, make a new chunk
     if (i.chunkPointer_->length_ >= (Chunk::CHUNKSIZE)) {
-        std::list<Chunk>::iterator nextChunk = i.chunkPointer_;
+        std::pmr::list<Chunk>::iterator nextChunk = i.chunkPointer_;
         ++nextChunk;
         Chunk newChunk = Chunk{0};
         nextChunk = chunks_.insert(nextChunk, newChunk);
+        count(&Counters::chunkAllocations_, 1);
+        count(&Counters::bytesShifted_, Chunk::CHUNKSIZE/2);
 
         // push half the elements onto the new chunk and fix lengths
         for (size_t n = 0; n < Chunk::CHUNKSIZE/2; ++n) {
@@ -196,11 +479,12 @@ ChunkyString::Iterator ChunkyString::insert(ChunkyString::Iterator i, char c) {
         }
         // fix the iterator if the index is now pointing to a different chunk
         if (i.index_ > Chunk::CHUNKSIZE/2) {
-            i = iterator{nextChunk, i.index_ - Chunk::CHUNKSIZE/2};
+            i = iterator{this, nextChunk, i.index_ - Chunk::CHUNKSIZE/2};
         }
     }
 
     // now we have chunks that aren't full, so we can perform a regular insert
+    count(&Counters::bytesShifted_, i.chunkPointer_->length_ - i.index_);
     for (size_t n = i.chunkPointer_->length_; n > i.index_; --n) {
         i.chunkPointer_->chars_[n] = i.chunkPointer_->chars_[n - 1];
     }
@@ -222,21 +506,35 @@ ChunkyString::Iterator ChunkyString::insert(ChunkyString::Iterator i, char c) {
     Finally, for cases 2 and 3 call reorder to optimize utlization.
 */
 ChunkyString::Iterator ChunkyString::erase(ChunkyString::Iterator i) {
+    i.settle();
+    // run chunks just get shorter (and become ordinary once they fit)
+    if (i.chunkPointer_->run_) {
+        --(i.chunkPointer_->length_);
+        --size_;
+        i.chunkPointer_->normalize();
+        if (i.index_ == i.chunkPointer_->length_) {
+            i = iterator{this, ++i.chunkPointer_, 0};
+        }
+        return i;
+    }
     // if the chunk has one element, delete the chunk!
     if (i.chunkPointer_->length_ == 1) {
         --size_;
-        std::list<Chunk>::iterator deletedChunk =
+        std::pmr::list<Chunk>::iterator deletedChunk =
         chunks_.erase(i.chunkPointer_);
+        count(&Counters::chunkFrees_, 1);
         // return an iterator to the place of the deleted chunk
-        return iterator{deletedChunk, 0};
+        return iterator{this, deletedChunk, 0};
     // otherwise, if the erasee is last in a chunk, delete it and change length
     } else {
         if (i.index_ == (i.chunkPointer_->length_ - 1)) {
             --(i.chunkPointer_->length_);
-            i = Iterator{i.chunkPointer_, i.index_};
+            i = Iterator{this, i.chunkPointer_, i.index_};
         // finally, if the character is at the beginning or in the middle of
         // a chunk, bump all other elements up 1 and decrement length
         } else {
+            count(&Counters::bytesShifted_,
+                  i.chunkPointer_->length_ - 1 - i.index_);
             for (size_t n = i.index_; n < i.chunkPointer_->length_- 1; ++n) {
                 i.chunkPointer_->chars_[n] = i.chunkPointer_->chars_[n + 1];
             }
@@ -250,28 +548,96 @@ ChunkyString::Iterator ChunkyString::erase(ChunkyString::Iterator i) {
     return i;
 }
 
+/*
+    Applies a sorted edit script by building a new, fully packed chunk list.
+    Stretches of characters between edits are copied with appendPiece; at
+    each edited position, the inserts go first and then the original
+    character is copied, replaced, or dropped. The new list only replaces
+    the old one once the whole script has been checked, so a bad script
+    leaves the string alone.
+*/
+void ChunkyString::apply(const EditScript& script) {
+    ChunkyString result{resource()};
+    EditScript::const_iterator edit = script.begin();
+    size_t position = 0;  // index of the current character before editing
+
+    for (const Chunk& chunk : chunks_) {
+        size_t offset = 0;
+        while (offset < chunk.length_) {
+            if (edit != script.end() && edit->position_ < position) {
+                throw std::invalid_argument("edit script is not sorted");
+            }
+            // copy everything up to the next edit (or the end of the chunk)
+            size_t stop = chunk.length_;
+            if (edit != script.end()) {
+                stop = std::min(stop, offset + (edit->position_ - position));
+            }
+            result.appendPiece(chunk, offset, stop);
+            position += stop - offset;
+            offset = stop;
+            if (offset == chunk.length_) {
+                break;
+            }
+
+            // apply every edit at this position to character `offset`
+            char c = chunk.chars_[chunk.run_ ? 0 : offset];
+            bool keep = true;
+            bool edited = false;
+            for (; edit != script.end() && edit->position_ == position;
+                 ++edit) {
+                if (edit->kind_ == Edit::INSERT) {
+                    result.push_back(edit->c_);
+                } else if (edited) {
+                    throw std::invalid_argument("character edited twice");
+                } else {
+                    edited = true;
+                    keep = (edit->kind_ == Edit::REPLACE);
+                    c = edit->c_;
+                }
+            }
+            if (keep) {
+                result.push_back(c);
+            }
+            ++offset;
+            ++position;
+        }
+    }
+
+    // only inserts can come after the last character
+    for (; edit != script.end(); ++edit) {
+        if (edit->kind_ != Edit::INSERT || edit->position_ != size_) {
+            throw std::invalid_argument("edit script position out of range");
+        }
+        result.push_back(edit->c_);
+    }
+
+    replaceChunks(result);
+}
+
 // redorders the chunkystring to maximize utilization
 ChunkyString::Iterator ChunkyString::reorder(ChunkyString::Iterator i) {
     // We call this when we erase. We have two alternatives
     // Set up iterators for the alternatives
-    std::list<Chunk>::iterator previousChunk = i.chunkPointer_;
+    std::pmr::list<Chunk>::iterator previousChunk = i.chunkPointer_;
     if (i.chunkPointer_ != chunks_.begin()) {
         --previousChunk;
     }
-    std::list<Chunk>::iterator nextChunk = i.chunkPointer_;
+    std::pmr::list<Chunk>::iterator nextChunk = i.chunkPointer_;
     ++nextChunk;
 
     // Option 1: the chunk we just erased from not at the beginning
     // and there is space for it to merge with the previous chunk
-    if (i.chunkPointer_ != chunks_.begin() && (i.chunkPointer_->length_ +
-     previousChunk->length_) <= Chunk::CHUNKSIZE) {
+    if (i.chunkPointer_ != chunks_.begin() && !previousChunk->run_ &&
+    (i.chunkPointer_->length_ + previousChunk->length_) <= Chunk::CHUNKSIZE) {
         // merge with the previous chunk
+        count(&Counters::bytesShifted_, i.chunkPointer_->length_);
+        count(&Counters::chunkFrees_, 1);
         for (size_t n = 0; n < i.chunkPointer_->length_; ++n) {
             previousChunk->chars_[previousChunk->length_ + n] =
             i.chunkPointer_->chars_[n];
         }
         // fix iterators and length.
-        ChunkyString::Iterator toReturn = iterator{previousChunk,
+        ChunkyString::Iterator toReturn = iterator{this, previousChunk,
         previousChunk->length_ + i.index_};
         previousChunk->length_ += i.chunkPointer_->length_;
         // remove the now empty chunk
@@ -279,9 +645,11 @@ ChunkyString::Iterator ChunkyString::reorder(ChunkyString::Iterator i) {
         return toReturn;
     // Option 2: the chunk we just erased from is not at the end
     // and there is space for it to merge with the next chunk
-    } else if (i.chunkPointer_ != (--chunks_.end()) &&
+    } else if (i.chunkPointer_ != (--chunks_.end()) && !nextChunk->run_ &&
     (i.chunkPointer_->length_ + nextChunk->length_) <= Chunk::CHUNKSIZE) {
         // add the next chunk to this chunk
+        count(&Counters::bytesShifted_, nextChunk->length_);
+        count(&Counters::chunkFrees_, 1);
         for (size_t n = 0; n < nextChunk->length_; ++n) {
             i.chunkPointer_->chars_[i.chunkPointer_->length_ + n] =
             nextChunk->chars_[n];
@@ -303,6 +671,51 @@ double ChunkyString::utilization() const {
     return size / capacity;
 }
 
+// Returns the memory resource the chunks are allocated from
+std::pmr::memory_resource* ChunkyString::resource() const {
+    return chunks_.get_allocator().resource();
+}
+
+// Adds up what each chunk uses. A list node is a Chunk plus two links, and
+// malloc adds a header and rounds up to its granularity.
+ChunkyString::MemoryUsage ChunkyString::memory_usage() const {
+    const size_t NODE_BYTES = sizeof(Chunk) + 2 * sizeof(void*);
+    const size_t HEAP_HEADER = sizeof(void*);
+    const size_t HEAP_GRANULARITY = 16;
+    const size_t HEAP_BLOCK = (NODE_BYTES + HEAP_HEADER + HEAP_GRANULARITY - 1)
+                              / HEAP_GRANULARITY * HEAP_GRANULARITY;
+
+    MemoryUsage usage = {};
+    usage.chunkCount_ = chunks_.size();
+    for (const Chunk& chunk : chunks_) {
+        usage.payloadBytes_ += chunk.run_ ? 1 : chunk.length_;
+    }
+    usage.unusedBytes_ =
+        usage.chunkCount_ * Chunk::CHUNKSIZE - usage.payloadBytes_;
+    usage.metadataBytes_ = sizeof(ChunkyString) +
+        usage.chunkCount_ * (NODE_BYTES - Chunk::CHUNKSIZE);
+    usage.allocatorOverheadBytes_ =
+        usage.chunkCount_ * (HEAP_BLOCK - NODE_BYTES);
+    return usage;
+}
+
+// Without CHUNKYSTRING_COUNTERS there are no counters to return, so every
+// string shares one set of zeros
+const ChunkyString::Counters& ChunkyString::counters() const {
+#if CHUNKYSTRING_COUNTERS
+    return counters_;
+#else
+    static const Counters NONE = {};
+    return NONE;
+#endif
+}
+
+void ChunkyString::resetCounters() {
+#if CHUNKYSTRING_COUNTERS
+    counters_ = Counters{};
+#endif
+}
+
 // Returns true for an empty ChunkyString
 bool ChunkyString::isEmpty() const {
     return (size_ == 0);
@@ -346,7 +759,12 @@ void ChunkyString::dump(const std::string& label) const {
     // Print the label so that we know where this output came from
     std::cerr << label << "|";
     // print size and contents of each chunk.
+    // run chunks are shown as count*char
     for (const Chunk& chunk : chunks_) {
+        if (chunk.run_) {
+            std::cerr << chunk.length_ << "*" << chunk.chars_[0] << "|";
+            continue;
+        }
         std::cerr << chunk.length_ << ":";
         for (size_t i = 0; i < chunk.length_; ++i) {
             std::cerr << chunk.chars_[i];
@@ -9,10 +9,27 @@
 #ifndef CHUNKYSTRING_HPP_INCLUDED
 #define CHUNKYSTRING_HPP_INCLUDED 1
 
+#include <algorithm>
 #include <cstddef>
 #include <iostream>
+#include <iterator>
 #include <list>
+#include <memory_resource>
 #include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+#ifndef CHUNKYSTRING_COUNTERS
+/* Set to 1 (e.g., with -DCHUNKYSTRING_COUNTERS=1) to have every ChunkyString
+ * count its chunk allocations and frees and the characters it shifts. The
+ * counters cost nothing when they're turned off: there's no code to update
+ * them and no space for them in the string. Everything that uses
+ * ChunkyString has to be compiled with the same setting
+ * (`make stringtest-counters` builds the tests that way).
+ */
+#define CHUNKYSTRING_COUNTERS 0
+#endif
 
 /**
  * \class ChunkyString
@@ -22,10 +39,13 @@
  * \details This class is comparable to a linked-list of characters,
  *   but more space efficient.
  *
+ *   Chunks are allocated from a `std::pmr::memory_resource`, so a string
+ *   can be placed in an arena (e.g., a `std::pmr::monotonic_buffer_resource`)
+ *   and released all at once along with the arena.
+ *
  * \remarks
- *   reverse_iterator and const_reverse_iterator aren't
- *   supported. Other than that, we use the STL container type declarations
- *   such that STL functions are compatible with ChunkyString.
+ *   We use the STL container type declarations such that STL functions are
+ *   compatible with ChunkyString.
  */
 class ChunkyString {
  private:
@@ -42,7 +62,53 @@ class ChunkyString {
   using const_reference = const value_type&;
   using iterator = Iterator;
   using const_iterator = ConstIterator;
-  // reverse_iterator and const_reverse_iterator aren't supported
+  using reverse_iterator = std::reverse_iterator<iterator>;
+  using const_reverse_iterator = std::reverse_iterator<const_iterator>;
+
+  /**
+   * \struct Edit
+   * \brief One operation in an EditScript
+   *
+   * \details Positions always refer to the string as it was *before* the
+   *          script was applied.
+   */
+  struct Edit {
+    enum Kind { INSERT, ERASE, REPLACE };
+    Kind kind_;
+    size_t position_;  ///< Index of the character the edit applies to
+    char c_;           ///< Character to insert or replace with
+  };
+
+  /// A list of edits, sorted by position
+  using EditScript = std::vector<Edit>;
+
+  /**
+   * \struct MemoryUsage
+   * \brief Where a ChunkyString's bytes go (see `memory_usage`)
+   */
+  struct MemoryUsage {
+    size_t payloadBytes_;   ///< Character cells holding characters
+    size_t unusedBytes_;    ///< Empty character cells in chunks
+    size_t chunkCount_;     ///< Number of chunks
+    size_t metadataBytes_;  ///< The object itself, chunk fields, list links
+    size_t allocatorOverheadBytes_;  ///< Estimated heap bookkeeping
+
+    /// Sum of all the byte counts
+    size_t totalBytes() const {
+      return payloadBytes_ + unusedBytes_ + metadataBytes_ +
+             allocatorOverheadBytes_;
+    }
+  };
+
+  /**
+   * \struct Counters
+   * \brief Work done by a ChunkyString (see CHUNKYSTRING_COUNTERS)
+   */
+  struct Counters {
+    size_t chunkAllocations_;  ///< Chunks created
+    size_t chunkFrees_;        ///< Chunks destroyed
+    size_t bytesShifted_;      ///< Characters moved within or between chunks
+  };
 
   /**
    * \brief Default constructor
@@ -51,7 +117,40 @@ class ChunkyString {
    * \note constant time
    */
   ChunkyString();
+
+  /**
+   * \brief Creates an empty string whose chunks come from `resource`
+   *
+   * \param resource  memory resource used for every chunk of this string;
+   *                  it must outlive the string
+   *
+   * \note constant time
+   */
+  explicit ChunkyString(std::pmr::memory_resource* resource);
+
+  /**
+   * \brief Copy constructor
+   * \details Like the standard pmr containers, the copy uses the default
+   *          memory resource rather than `other`'s.
+   */
   ChunkyString(const ChunkyString& other);
+
+  /// Copy constructor placing the copy's chunks in `resource`
+  ChunkyString(const ChunkyString& other,
+               std::pmr::memory_resource* resource);
+
+  /**
+   * \brief Creates a string holding a copy of `text`
+   *
+   * \details Characters are copied a whole chunk at a time.
+   *
+   * \note linear time
+   */
+  explicit ChunkyString(std::string_view text,
+                        std::pmr::memory_resource* resource =
+                            std::pmr::get_default_resource());
+
+  /// Assignment keeps this string's own memory resource
   ChunkyString& operator= (const ChunkyString& other);
   ~ChunkyString() = default;
 
@@ -80,6 +179,37 @@ class ChunkyString {
   /// Old-style end() for constant ChunkyStrings
   const_iterator end() const { return cend(); }
 
+  /// Return a reverse_iterator to the last character in the ChunkyString.
+  reverse_iterator rbegin();
+
+  /// Return a reverse_iterator to "one before the beginning"
+  reverse_iterator rend();
+
+  /// Return a const_reverse_iterator to the last character
+  const_reverse_iterator crbegin() const;
+
+  /// Return a const_reverse_iterator to "one before the beginning"
+  const_reverse_iterator crend() const;
+
+  /// Old-style rbegin() for constant ChunkyStrings
+  const_reverse_iterator rbegin() const { return crbegin(); }
+
+  /// Old-style rend() for constant ChunkyStrings
+  const_reverse_iterator rend() const { return crend(); }
+
+  /**
+   * \brief Find the last occurrence of a character
+   *
+   * \details Scans backward from the end a chunk at a time, so finding
+   *          something near the end of a long string is cheap.
+   *
+   * \returns an iterator to the last `c`, or `end()` if there isn't one
+   *
+   * \note linear in the distance from the end
+   */
+  iterator rfind(char c);
+  const_iterator rfind(char c) const;  ///< rfind for constant ChunkyStrings
+
   /**
    * \brief Insert a character at the end of the ChunkyString.
    *
@@ -88,6 +218,95 @@ class ChunkyString {
    * \note constant time
    */
   void push_back(char c);
+
+  /**
+   * \brief Append `count` copies of `c` to the end of the ChunkyString.
+   *
+   * \details Long runs are kept as a single run chunk holding just the
+   *          character and its count. Run chunks are expanded lazily, one
+   *          piece at a time, when `insert` puts a different character
+   *          inside them.
+   *
+   * \note constant time
+   *
+   * \remarks Dereferencing a (non-const) `iterator` inside a run expands
+   *          the piece of the run it points to, so writes through it only
+   *          change that character. Read through `const_iterator`s to keep
+   *          runs compressed.
+   */
+  void appendRun(char c, size_t count);
+
+  /**
+   * \brief Append all of `text` to the end of the ChunkyString.
+   *
+   * \details Fills the last chunk, then copies whole chunks at a time.
+   *
+   * \note linear in the length of `text`
+   */
+  ChunkyString& append(std::string_view text);
+
+  /**
+   * \brief Copy the string into a std::string
+   *
+   * \details Allocates once (for `size()` characters) and copies a chunk
+   *          at a time.
+   */
+  std::string to_string() const;
+
+  /**
+   * \brief Hand the string's characters to `visit`, in order, a piece at a
+   *        time
+   *
+   * \details `visit` is called with a `std::string_view` for each ordinary
+   *          chunk; run chunks are handed over as several views of
+   *          repeated characters. The views are only good during the call.
+   *
+   * \note linear time, with one call per chunk
+   */
+  template <typename Visitor>
+  void forEachSegment(Visitor visit) const {
+    forEachSegment(cbegin(), size_, visit);
+  }
+
+  /**
+   * \brief Like forEachSegment(visit), but only for the `count` characters
+   *        starting at `first`
+   *
+   * \note linear in the number of chunks visited
+   */
+  template <typename Visitor>
+  void forEachSegment(const_iterator first, size_t count,
+                      Visitor visit) const {
+    const size_t RUN_PIECE = 64;
+    first.settle();
+    auto chunk = first.chunkPointer_;
+    size_t offset = first.index_;
+    for (; count > 0; ++chunk, offset = 0) {
+      size_t length = std::min(chunk->length_ - offset, count);
+      count -= length;
+      if (!chunk->run_) {
+        visit(std::string_view{chunk->chars_ + offset, length});
+        continue;
+      }
+      char copies[RUN_PIECE];
+      std::fill(copies, copies + RUN_PIECE, chunk->chars_[0]);
+      for (size_t left = length; left > 0;) {
+        size_t piece = std::min(left, RUN_PIECE);
+        visit(std::string_view{copies, piece});
+        left -= piece;
+      }
+    }
+  }
+
+  /**
+   * \brief Turn every run of more than CHUNKSIZE identical characters
+   *        into a run chunk.
+   *
+   * \note linear time
+   *
+   * \warning invalidates all iterators
+   */
+  void compact();
   ChunkyString::Iterator reorder(iterator i);
   size_t size() const;  ///< String size \note constant time
 
@@ -95,11 +314,19 @@ class ChunkyString {
   bool operator!=(const ChunkyString& rhs) const;  ///< String inequality
   bool isEmpty() const;
 
+  /// Equality with any string-like text; doesn't allocate
+  bool operator==(std::string_view rhs) const;
+  bool operator!=(std::string_view rhs) const;  ///< Inequality with text
+  bool operator<(std::string_view rhs) const;   ///< Comparison with text
+
   std::ostream& print(std::ostream& out) const;  ///< String printing
   std::ostream& printChunks(std::ostream& out) const;  ///< String printing
 
   void dump(const std::string& label) const;  ///< Debug printing
 
+  /// The memory resource this string's chunks are allocated from
+  std::pmr::memory_resource* resource() const;
+
   /**
    * \brief String concatenation
    *
@@ -161,6 +388,30 @@ class ChunkyString {
    */
   iterator erase(iterator i);
 
+  /**
+   * \brief Apply a whole list of edits in one pass
+   *
+   * \details
+   *   Rebuilds the string left to right, so applying any number of edits
+   *   costs time linear in the length of the string, with no chunk
+   *   splitting or merging along the way.
+   *
+   *   The script must be sorted by position. All INSERTs at position p go
+   *   (in script order) before the original character p, and position
+   *   `size()` appends. Each original character may be the target of at
+   *   most one ERASE or REPLACE.
+   *
+   * \param script   the edits to apply
+   *
+   * \throws std::invalid_argument if the script is out of order, out of
+   *   range, or edits a character twice; the string is left unchanged.
+   *
+   * \note linear time
+   *
+   * \warning invalidates all iterators
+   */
+  void apply(const EditScript& script);
+
   /**
    * \brief Average capacity of each chunk, as a fraction
    *
@@ -176,12 +427,32 @@ class ChunkyString {
    *   chunk; otherwise the data structure would be wasting too much space.
    *
    *   The utilization for an empty string is undefined (i.e., any value is
-   *   acceptable).
+   *   acceptable). Strings holding run chunks (see `appendRun`) can have a
+   *   utilization greater than one.
    *
    * \note constant time
    */
   double utilization() const;
 
+  /**
+   * \brief Break down the memory used by the string
+   *
+   * \details A run chunk's payload is its one stored character. List links
+   *          and allocator overhead are estimates for a typical 64-bit
+   *          malloc (a pointer-sized header, 16-byte granularity); a
+   *          monotonic arena has less overhead than that.
+   *
+   * \note linear in the number of chunks
+   */
+  MemoryUsage memory_usage() const;
+
+  /// Counts of chunk allocations/frees and shifted characters since the
+  /// string was created; all zero unless CHUNKYSTRING_COUNTERS is set
+  const Counters& counters() const;
+
+  /// Zero the counters
+  void resetCounters();
+
  private:
   // NOTE: You can choose to change Chunk to be a class rather than a struct
   /**
@@ -200,11 +471,69 @@ class ChunkyString {
     static const size_t CHUNKSIZE = 12;
     size_t length_;  ///< Number of characters occupying this chunk
     char chars_[CHUNKSIZE];  ///< Contents of this chunk
+
+    /**
+     * \brief True if this chunk is `length_` copies of `chars_[0]`
+     *
+     * \remarks Run chunks always have `length_ > CHUNKSIZE`; shorter runs
+     *          are stored as ordinary chunks (see `normalize`).
+     */
+    bool run_;
+
     Chunk();
     Chunk(size_t length);
+    Chunk(char c, size_t count);  ///< Run chunk (if `count` is large)
     ~Chunk() = default;
+
+    /// Convert a run chunk that now fits into an ordinary chunk
+    void normalize();
   };
 
+  /**
+   * \brief Split the run chunk at `chunk` so that its `index`th character
+   *        starts a chunk of its own.
+   *
+   * \returns the chunk that now starts with that character
+   */
+  std::pmr::list<Chunk>::iterator splitRun(
+      std::pmr::list<Chunk>::iterator chunk, size_t index);
+
+  /**
+   * \brief Find the last `c` in the chunks [first, last), for both rfinds
+   *
+   * \returns the chunk holding it and its index there, or `{last, 0}`
+   */
+  template <typename ChunkIter>
+  static std::pair<ChunkIter, size_t> lastOf(ChunkIter first, ChunkIter last,
+                                             char c);
+
+  /**
+   * \brief Expand the run chunk at `chunk` so that its `index`th character
+   *        starts an ordinary chunk that can be written to.
+   *
+   * \details The characters before `index` stay in `chunk`, and the rest
+   *          go in new chunks right after it, so iterators into the run
+   *          still find their characters (see `Iterator::settle`).
+   *
+   * \returns the ordinary chunk that now starts with that character
+   */
+  std::pmr::list<Chunk>::iterator expandRun(
+      std::pmr::list<Chunk>::iterator chunk, size_t index);
+
+  /// Append characters [first, last) of `chunk`, keeping runs compressed
+  void appendPiece(const Chunk& chunk, size_t first, size_t last);
+
+  /// Replace our chunks with those of `rebuilt` (which uses our resource)
+  void replaceChunks(ChunkyString& rebuilt);
+
+  /// Add to one of the counters (compiled away unless CHUNKYSTRING_COUNTERS)
+  void count([[maybe_unused]] size_t Counters::*counter,
+             [[maybe_unused]] size_t amount) {
+#if CHUNKYSTRING_COUNTERS
+    counters_.*counter += amount;
+#endif
+  }
+
   /**
    * \class Iterator
    * \brief STL-style iterator for ChunkyString.
@@ -241,19 +570,28 @@ class ChunkyString {
      *  a variable whose type is an iterator for a chunk list, you
      *  should use `chunk_iter_t` for the type name.
      */
-    using chunk_iter_t = std::list<Chunk>::iterator;
+    using chunk_iter_t = std::pmr::list<Chunk>::iterator;
 
-    Iterator(chunk_iter_t chunkPtr, size_t i);
+    Iterator(ChunkyString* owner, chunk_iter_t chunkPtr, size_t i);
     Iterator& operator=(const Iterator& other);
     ~Iterator() = default;
 
     // Operations
     Iterator& operator++();
     Iterator& operator--();
+
+    /// Expands the character's piece of a run first (see `expandRun`)
     reference operator*() const;
     bool operator==(const Iterator& rhs) const;
     bool operator!=(const Iterator& rhs) const;
 
+    /**
+     * \brief Move forward n characters, skipping whole chunks at a time
+     *
+     * \warning moving past end() is undefined behavior
+     */
+    Iterator& advance(size_t n);
+
 
     chunk_iter_t chunkPointer_;
     size_t index_;
@@ -261,7 +599,16 @@ class ChunkyString {
    private:
     friend class ChunkyString;
 
-    // TODO: Add private member functions, including constructors, as needed
+    /**
+     * \brief Move on to the chunk that really holds character `index_`
+     *
+     * \details Expanding a run leaves iterators into it pointing at the
+     *          run's first chunk with an index past its end; the
+     *          characters they mean are in the chunks that follow.
+     */
+    void settle();
+
+    ChunkyString* owner_;  ///< String to expand runs in
   };
 
   /**
@@ -305,7 +652,7 @@ class ChunkyString {
      *  a variable whose type is an iterator for a chunk list, you
      *  should use `chunk_iter_t` for the type name.
      */
-    using chunk_iter_t = std::list<Chunk>::const_iterator;
+    using chunk_iter_t = std::pmr::list<Chunk>::const_iterator;
 
     ConstIterator(chunk_iter_t chunkPtr, size_t i);
     chunk_iter_t chunkPointer_;
@@ -318,16 +665,25 @@ class ChunkyString {
     bool operator==(const ConstIterator& rhs) const;
     bool operator!=(const ConstIterator& rhs) const;
 
+    /// Move forward n characters, skipping whole chunks at a time
+    ConstIterator& advance(size_t n);
+
    private:
     friend class ChunkyString;
 
+    /// Move on to the chunk that really holds character `index_`
+    void settle();
+
     // TODO: Add private data members, for encoding
     // TODO: Add private member functions, including constructors, as needed
   };
 
   // ChunkyString data members
-  size_t size_;              ///< Length of the string
-  std::list<Chunk> chunks_;  ///< Linked list of chunks
+  size_t size_;                   ///< Length of the string
+  std::pmr::list<Chunk> chunks_;  ///< Linked list of chunks
+#if CHUNKYSTRING_COUNTERS
+  Counters counters_ = {};        ///< See CHUNKYSTRING_COUNTERS
+#endif
 };
 
 
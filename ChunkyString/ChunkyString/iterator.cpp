@@ -12,13 +12,15 @@
 // ----------------------- Iterator stubs: ----------------------
 
 // default constructor
-ChunkyString::Iterator::Iterator() : chunkPointer_{}, index_{0} {
+ChunkyString::Iterator::Iterator()
+    : chunkPointer_{}, index_{0}, owner_{nullptr} {
     // nothing to do here
 }
 
-// 2 Parameter contructor : chunk_iter_t and size_t
-ChunkyString::Iterator::Iterator(chunk_iter_t chunkPtr, size_t i)
-    : chunkPointer_{}, index_{0} {
+// 3 Parameter contructor : owner, chunk_iter_t and size_t
+ChunkyString::Iterator::Iterator(ChunkyString* owner, chunk_iter_t chunkPtr,
+                                 size_t i)
+    : chunkPointer_{}, index_{0}, owner_{owner} {
     chunkPointer_ = chunkPtr;
     index_ = i;
 }
@@ -28,22 +30,24 @@ ChunkyString::Iterator& ChunkyString::Iterator::
 operator=(const Iterator& other) {
     chunkPointer_ = other.chunkPointer_;
     index_ = other.index_;
+    owner_ = other.owner_;
 
     return *this;
 }
 
-// Iterator increment
-ChunkyString::Iterator& ChunkyString::Iterator::operator++() {
-    // if iterator is not at the last element in a chunk,
-    // increment index
-    if (index_ < chunkPointer_->length_- 1) {
-        ++index_;
-    } else {
-        // index is at the last element of the chuck, so move iterator
-        // to point at the first element of the next chunk
-        index_ = 0;
+// Skips chunks until index_ is inside one (or is the start of the next)
+void ChunkyString::Iterator::settle() {
+    while (index_ != 0 && index_ >= chunkPointer_->length_) {
+        index_ -= chunkPointer_->length_;
         ++chunkPointer_;
     }
+}
+
+// Iterator increment
+ChunkyString::Iterator& ChunkyString::Iterator::operator++() {
+    // moving past the end of a chunk moves to the start of the next one
+    ++index_;
+    settle();
     return *this;
 }
 
@@ -64,15 +68,29 @@ ChunkyString::Iterator& ChunkyString::Iterator::operator--() {
 
 // Iterator dereference
 ChunkyString::Iterator::reference ChunkyString::Iterator::operator*() const {
+    Iterator here = *this;
+    here.settle();
+    // a run chunk stores its character only once, so writing to it would
+    // change the whole run; give this character a chunk of its own first
+    // (end() has no chunk, so there's nothing to expand)
+    if (here.chunkPointer_ != owner_->chunks_.end() &&
+        here.chunkPointer_->run_) {
+        return owner_->expandRun(here.chunkPointer_, here.index_)->chars_[0];
+    }
     // return the element referenced by the iterator
-    return (chunkPointer_->chars_[index_]);
+    return (here.chunkPointer_->chars_[here.index_]);
 }
 
 // Iterator equals
 bool ChunkyString::Iterator::operator==(const Iterator& rhs) const {
-    // see if both data members of both iterators are equal
-    if (this->chunkPointer_ == rhs.chunkPointer_
-        && this->index_ == rhs.index_) {
+    // see if both data members of both iterators are equal, once they
+    // point at the chunks that really hold their characters
+    Iterator lhs = *this;
+    Iterator other = rhs;
+    lhs.settle();
+    other.settle();
+    if (lhs.chunkPointer_ == other.chunkPointer_
+        && lhs.index_ == other.index_) {
         return true;
     }
     return false;
@@ -84,6 +102,14 @@ bool ChunkyString::Iterator::operator!=(const Iterator& rhs) const {
     return !(*this == rhs);
 }
 
+// Iterator advance
+ChunkyString::Iterator& ChunkyString::Iterator::advance(size_t n) {
+    // settle hops over whole chunks until the target is inside one
+    index_ += n;
+    settle();
+    return *this;
+}
+
 // ----------------------- ConstIterator stubs: ----------------------
 
 
@@ -111,18 +137,19 @@ operator=(const ConstIterator& other) {
     return *this;
 }
 
-// Iterator increment
-ChunkyString::ConstIterator& ChunkyString::ConstIterator::operator++() {
-    // if iterator is not at the last element in a chunk,
-    // increment index
-    if (index_ < chunkPointer_->length_- 1) {
-        ++index_;
-    } else {
-        // index is at the last element of the chuck, so move iterator
-        // to point at the first element of the next chunk
-        index_ = 0;
+// Skips chunks until index_ is inside one (or is the start of the next)
+void ChunkyString::ConstIterator::settle() {
+    while (index_ != 0 && index_ >= chunkPointer_->length_) {
+        index_ -= chunkPointer_->length_;
         ++chunkPointer_;
     }
+}
+
+// Iterator increment
+ChunkyString::ConstIterator& ChunkyString::ConstIterator::operator++() {
+    // moving past the end of a chunk moves to the start of the next one
+    ++index_;
+    settle();
     return *this;
 }
 
@@ -144,14 +171,23 @@ ChunkyString::ConstIterator& ChunkyString::ConstIterator::operator--() {
 // Iterator dereference
 ChunkyString::ConstIterator::reference ChunkyString::ConstIterator::
 operator*() const {
-    return (chunkPointer_->chars_[index_]);
+    ConstIterator here = *this;
+    here.settle();
+    // a run chunk stores its character only once
+    return (here.chunkPointer_->chars_[here.chunkPointer_->run_ ?
+                                       0 : here.index_]);
 }
 
 // Iterator equals
 bool ChunkyString::ConstIterator::operator==(const ConstIterator& rhs) const {
-    // see if both data members of both iterators are equal
-    if (this->chunkPointer_ == rhs.chunkPointer_
-        && this->index_ == rhs.index_) {
+    // see if both data members of both iterators are equal, once they
+    // point at the chunks that really hold their characters
+    ConstIterator lhs = *this;
+    ConstIterator other = rhs;
+    lhs.settle();
+    other.settle();
+    if (lhs.chunkPointer_ == other.chunkPointer_
+        && lhs.index_ == other.index_) {
         return true;
     }
     return false;
@@ -162,3 +198,11 @@ bool ChunkyString::ConstIterator::operator!=(const ConstIterator& rhs) const {
     // return !=
     return !(*this == rhs);
 }
+
+// Iterator advance
+ChunkyString::ConstIterator& ChunkyString::ConstIterator::advance(size_t n) {
+    // settle hops over whole chunks until the target is inside one
+    index_ += n;
+    settle();
+    return *this;
+}
@@ -7,29 +7,68 @@
  *
  */
 
+#include <chrono>
+#include <cstdint>
 #include <fstream>
+#include <iomanip>
 #include <iostream>
 #include <list>
 #include <random>
+#include <memory>
 #include <string>
+#include <string_view>
+#include <thread>
+#include "bounded-queue.hpp"
 #include "chunkystring.hpp"
 #include "noisy-transmission.hpp"
 
+/// Settings chosen on the command line
+struct Options {
+  std::string filename;       ///< File to read original message from
+  float noiseLevel = 0;       ///< Likelihood of a character being modified
+  std::string mode = "inplace";  ///< How to transmit (see processOptions)
+  bool seeded = false;        ///< Set if a seed was given
+  uint64_t seed = 0;          ///< Seed for the random number generator
+  size_t threads = 0;         ///< Threads for "parallel" (0: one per core)
+  size_t blockBytes = 1 << 16;  ///< Block size for "pipeline"
+  std::string bench;          ///< Report format ("text", "json" or "csv")
+};
+
+/// Measurements for a --bench run
+struct BenchReport {
+  size_t inputBytes = 0;     ///< Size of the original message
+  size_t outputBytes = 0;    ///< Size of the garbled message
+  double loadSeconds = 0;    ///< Time to read the file into a ChunkyString
+  double transmitSeconds = 0;  ///< Time to garble it
+  double printSeconds = 0;   ///< Time to write it out
+  size_t inserts = 0;        ///< Characters doubled
+  size_t erases = 0;         ///< Characters deleted
+  bool garbledString = false;  ///< Set if the mode made a garbled
+                               ///< ChunkyString (not "stream")
+  size_t chunks = 0;         ///< Chunks in the garbled message
+  double utilization = 0;    ///< Utilization of the garbled message
+};
+
 /**
  * \brief Option Processing
  * \details
- *   Sets various configuration variables by modifying variables passed
+ *   Sets various configuration variables by modifying the settings passed
  *   by reference.
  *
  *   Will return with an exit error of 2 if receives a usage problem.
  *
+ *   The mode is "inplace" to garble the message in place, "stream" to
+ *   write the garbled copy straight out, "parallel" to garble segments on
+ *   several threads, or "pipeline" to read, garble and write fixed-size
+ *   blocks on three threads without ever holding the whole file.
+ *
+ *   With `--bench text|json|csv`, a report of where the time went is
+ *   written to standard error once the message has been printed.
+ *
  * \param options       Input of options from command line.
- * \param seed          Optional seed value for random number generator
- * \param filename      Name of file to read original message from
- * \param noiseLevel    Likelihood of a character being modified
+ * \param settings      Settings to fill in
  */
-void processOptions(std::list<std::string> options, std::string& filename,
-                    float& noiseLevel) {
+void processOptions(std::list<std::string> options, Options& settings) {
   // Loop through the options. If they start with a dash
   // try to interpret them as a flag; if not, assume it's
   // the number of insertions.
@@ -51,14 +90,36 @@ void processOptions(std::list<std::string> options, std::string& filename,
 
     if (flag == "-n" || flag == "--noise") {
       // This flag provides the noise level
-      noiseLevel = stod(value);
+      settings.noiseLevel = stod(value);
     } else if (flag == "-f" || flag == "--filename") {
       // This flag provides the filename
-      filename = value;
+      settings.filename = value;
+    } else if ((flag == "-m" || flag == "--mode") &&
+               (value == "inplace" || value == "stream" ||
+                value == "parallel" || value == "pipeline")) {
+      // This flag chooses how to transmit
+      settings.mode = value;
+    } else if (flag == "-s" || flag == "--seed") {
+      // This flag makes the garbling repeatable
+      settings.seeded = true;
+      settings.seed = stoull(value);
+    } else if (flag == "-t" || flag == "--threads") {
+      // This flag provides the number of threads for parallel mode
+      settings.threads = stoul(value);
+    } else if ((flag == "-b" || flag == "--block") && stoul(value) > 0) {
+      // This flag provides the block size for pipeline mode
+      settings.blockBytes = stoul(value);
+    } else if ((flag == "-B" || flag == "--bench") &&
+               (value == "text" || value == "json" || value == "csv")) {
+      // This flag asks for timings and statistics
+      settings.bench = value;
     } else {
       // Unknown flag: print message about how to use this program
       std::cerr << "Unrecognized option: " << flag << std::endl;
-      std::cerr << "Usage: ./messagePasser -n noise -f filename" << std::endl;
+      std::cerr << "Usage: ./messagePasser -n noise -f filename "
+                << "[-m inplace|stream|parallel|pipeline] [-s seed] "
+                << "[-t threads] [-b blockBytes] [-B text|json|csv]"
+                << std::endl;
       exit(2);
     }
   }
@@ -66,40 +127,232 @@ void processOptions(std::list<std::string> options, std::string& filename,
   return;
 }
 
+/**
+ * \brief Garble a message of any size in constant memory
+ *
+ * \details One thread reads `blockBytes` at a time into a ChunkyString,
+ *          this thread garbles each block, and another thread writes the
+ *          garbled blocks out. The stages are joined by bounded queues, so
+ *          at most a few blocks are ever in memory, and reading, garbling
+ *          and writing overlap.
+ *
+ *          Corruptions are independent from character to character, so
+ *          garbling block by block gives the same distribution of results
+ *          as garbling the whole message at once.
+ *
+ *          Like the other modes, the output ends with a newline even if
+ *          the file doesn't.
+ */
+void transmitPipeline(std::istream& in, std::ostream& out,
+                      NoisyTransmission& channel, size_t blockBytes) {
+  using Block = std::unique_ptr<ChunkyString>;
+  const size_t QUEUE_BLOCKS = 4;
+  BoundedQueue<Block> toTransmit{QUEUE_BLOCKS};
+  BoundedQueue<Block> toWrite{QUEUE_BLOCKS};
+
+  std::thread reader{[&]() {
+    std::string buffer(blockBytes, '\0');
+    char last = '\n';
+    while (in.read(&buffer[0], blockBytes) || in.gcount() > 0) {
+      std::string_view piece{buffer.data(), size_t(in.gcount())};
+      last = piece.back();
+      toTransmit.push(std::make_unique<ChunkyString>(piece));
+    }
+    if (last != '\n') {
+      toTransmit.push(std::make_unique<ChunkyString>("\n"));
+    }
+    toTransmit.close();
+  }};
+
+  std::thread writer{[&]() {
+    Block block;
+    while (toWrite.pop(block)) {
+      block->forEachSegment([&out](std::string_view piece) {
+        out.write(piece.data(), piece.size());
+      });
+    }
+  }};
+
+  Block block;
+  while (toTransmit.pop(block)) {
+    toWrite.push(std::make_unique<ChunkyString>(channel.transmitted(*block)));
+  }
+  toWrite.close();
+
+  reader.join();
+  writer.join();
+}
+
+/// Megabytes per second, or 0 if the stage took no measurable time
+double megabytesPerSecond(size_t bytes, double seconds) {
+  return seconds > 0 ? bytes / seconds / 1e6 : 0;
+}
+
+/**
+ * \brief Write a --bench report
+ *
+ * \details "text" is for people; "json" is one object and "csv" is a
+ *          header line and one row, for scripts that track performance
+ *          from build to build. When a mode writes the message while it
+ *          garbles it ("stream"), that writing counts as transmit time,
+ *          and since there's no garbled ChunkyString, its chunks and
+ *          utilization are null in JSON, empty in CSV and left out of
+ *          the text.
+ */
+void printReport(std::ostream& out, const Options& settings,
+                 const BenchReport& report) {
+  const char* stages[] = {"load", "transmit", "print"};
+  double seconds[] = {report.loadSeconds, report.transmitSeconds,
+                      report.printSeconds};
+  size_t bytes[] = {report.inputBytes, report.inputBytes,
+                    report.outputBytes};
+
+  if (settings.bench == "json") {
+    out << "{\"mode\": \"" << settings.mode << "\", \"noise\": "
+        << settings.noiseLevel << ", \"inputBytes\": " << report.inputBytes
+        << ", \"outputBytes\": " << report.outputBytes;
+    for (size_t i = 0; i < 3; ++i) {
+      out << ", \"" << stages[i] << "\": {\"seconds\": " << seconds[i]
+          << ", \"MBps\": " << megabytesPerSecond(bytes[i], seconds[i])
+          << "}";
+    }
+    out << ", \"inserts\": " << report.inserts << ", \"erases\": "
+        << report.erases;
+    if (report.garbledString) {
+      out << ", \"chunks\": " << report.chunks << ", \"utilization\": "
+          << report.utilization;
+    } else {
+      out << ", \"chunks\": null, \"utilization\": null";
+    }
+    out << "}" << std::endl;
+  } else if (settings.bench == "csv") {
+    out << "mode,noise,input_bytes,output_bytes";
+    for (const char* stage : stages) {
+      out << "," << stage << "_seconds," << stage << "_MBps";
+    }
+    out << ",inserts,erases,chunks,utilization" << std::endl;
+    out << settings.mode << "," << settings.noiseLevel << ","
+        << report.inputBytes << "," << report.outputBytes;
+    for (size_t i = 0; i < 3; ++i) {
+      out << "," << seconds[i] << ","
+          << megabytesPerSecond(bytes[i], seconds[i]);
+    }
+    out << "," << report.inserts << "," << report.erases << ",";
+    if (report.garbledString) {
+      out << report.chunks << "," << report.utilization;
+    } else {
+      out << ",";
+    }
+    out << std::endl;
+  } else {
+    out << "mode " << settings.mode << ", noise " << settings.noiseLevel
+        << ", " << report.inputBytes << " bytes in, " << report.outputBytes
+        << " bytes out" << std::endl;
+    for (size_t i = 0; i < 3; ++i) {
+      out << std::left << std::setw(10) << stages[i] << std::right
+          << std::setw(12) << seconds[i] << " s" << std::setw(12)
+          << megabytesPerSecond(bytes[i], seconds[i]) << " MB/s"
+          << std::endl;
+    }
+    out << report.inserts << " inserts, " << report.erases << " erases";
+    if (report.garbledString) {
+      out << ", " << report.chunks << " chunks, utilization "
+          << report.utilization;
+    }
+    out << std::endl;
+  }
+}
+
 int main(int argc, const char* argv[]) {
-  float noiseLevel = 0;
-  std::string fileName;
+  Options settings;
 
   // Process the command-line options (provided in argv)
   std::list<std::string> options(argv + 1, argv + argc);
-  processOptions(options, fileName, noiseLevel);
+  processOptions(options, settings);
 
-  std::ifstream fileReader(fileName);
+  std::ifstream fileReader(settings.filename);
 
   if (!fileReader.is_open()) {
-    std::cerr << "Unable to read from file" << fileName << std::endl;
+    std::cerr << "Unable to read from file" << settings.filename
+              << std::endl;
     exit(-1);
   } else {
+    NoisyTransmission transmissionLine =
+        settings.seeded
+            ? NoisyTransmission{settings.noiseLevel, settings.seed}
+            : NoisyTransmission{settings.noiseLevel};
+
+    // Pipeline mode never reads the whole file in
+    if (settings.mode == "pipeline") {
+      if (!settings.bench.empty()) {
+        std::cerr << "--bench can't time the stages of pipeline mode "
+                  << "separately" << std::endl;
+        exit(2);
+      }
+      transmitPipeline(fileReader, std::cout, transmissionLine,
+                       settings.blockBytes);
+      std::cout << std::endl;
+      return 0;
+    }
+
+    using Clock = std::chrono::steady_clock;
+    auto seconds = [](Clock::time_point start, Clock::time_point end) {
+      return std::chrono::duration<double>(end - start).count();
+    };
+    BenchReport report;
+
     // The file is open: create a ChunkyString that contains
     // the file contents, then transmit the contents.
 
     // Build a ChunkyString from the file contents
+    auto loadStart = Clock::now();
     std::string messageLine;
     ChunkyString message;
 
     while (getline(fileReader, messageLine)) {
-      for (const char c : messageLine) {
-        message.push_back(c);
-      }
+      message.append(messageLine);
       message.push_back('\n');
     }
+    auto transmitStart = Clock::now();
 
-    // Transmit the message on a noisy channel
-    NoisyTransmission transmissionLine{noiseLevel};
-    transmissionLine.transmit(message);
+    // Transmit the message on a noisy channel and print the garbled message,
+    // either after editing it in place, as it's produced, or after
+    // garbling it on several threads
+    report.inputBytes = message.size();
+    ChunkyString result =
+        settings.mode == "parallel"
+            ? transmissionLine.transmitParallel(message, settings.threads)
+            : ChunkyString{};
+    const ChunkyString* garbled =
+        settings.mode == "parallel" ? &result : &message;
+    if (settings.mode == "stream") {
+      transmissionLine.transmit(message, std::cout);
+      report.outputBytes = message.size() + transmissionLine.stats().inserts_ -
+                           transmissionLine.stats().erases_;
+    } else if (settings.mode == "inplace") {
+      transmissionLine.transmit(message);
+    }
+    auto printStart = Clock::now();
+    if (settings.mode != "stream") {
+      std::cout << *garbled;
+      report.outputBytes = garbled->size();
+    }
+    std::cout << std::endl;
+    auto printEnd = Clock::now();
 
-    // Print the garbled message
-    std::cout << message << std::endl;
+    if (!settings.bench.empty()) {
+      report.loadSeconds = seconds(loadStart, transmitStart);
+      report.transmitSeconds = seconds(transmitStart, printStart);
+      report.printSeconds = seconds(printStart, printEnd);
+      report.inserts = transmissionLine.stats().inserts_;
+      report.erases = transmissionLine.stats().erases_;
+      if (settings.mode != "stream") {
+        report.garbledString = true;
+        report.chunks = garbled->memory_usage().chunkCount_;
+        report.utilization = garbled->utilization();
+      }
+      printReport(std::cerr, settings, report);
+    }
 
     return 0;
   }
@@ -11,38 +11,232 @@
  * \remarks
  *
  */
+#include <algorithm>
+#include <atomic>
+#include <cmath>
 #include <fstream>
 #include <iostream>
+#include <limits>
 #include <random>
 #include "noisy-transmission.hpp"
 #include <stdexcept>
+#include <string>
+#include <thread>
+#include <vector>
 #include "chunkystring.hpp"
 
-NoisyTransmission::NoisyTransmission(float errorRate)
-    : errorRate_(errorRate), dis_(0, 1) {
+template <typename Engine>
+BasicNoisyTransmission<Engine>::BasicNoisyTransmission(float errorRate)
+    : errorRate_(errorRate),
+      eventRate_(std::min(1.0, 2.0 * errorRate)),
+      logKeep_(std::log1p(-eventRate_)),
+      batchPosition_(BATCH_SIZE) {
+  std::random_device rd;
+  seed_ = (uint64_t(rd()) << 32) | rd();
   seed();
 }
 
-void NoisyTransmission::seed() {
-  std::random_device rd;
-  gen_.seed(rd());
+template <typename Engine>
+BasicNoisyTransmission<Engine>::BasicNoisyTransmission(float errorRate,
+                                                       uint64_t seed)
+    : errorRate_(errorRate),
+      eventRate_(std::min(1.0, 2.0 * errorRate)),
+      logKeep_(std::log1p(-eventRate_)),
+      seed_(seed),
+      batchPosition_(BATCH_SIZE) {
+  this->seed();
+}
+
+template <typename Engine>
+void BasicNoisyTransmission<Engine>::seed() {
+  seedEngine(gen_, seed_);
+}
+
+// Mixes the index into the seed, so neighbouring segments get unrelated
+// generators
+template <typename Engine>
+uint64_t BasicNoisyTransmission<Engine>::segmentSeed(uint64_t seed,
+                                                     size_t index) {
+  return splitmix64(seed + (index + 1) * 0x9e3779b97f4a7c15ULL);
 }
 
-float NoisyTransmission::getRandomFloat() { return dis_(gen_); }
+// Draws the raw bits first and converts them afterwards, so the conversion
+// loop has no calls in it and the compiler can vectorize it
+template <typename Engine>
+void BasicNoisyTransmission<Engine>::refill() {
+  typename Engine::result_type bits[BATCH_SIZE];
+  for (size_t i = 0; i < BATCH_SIZE; ++i) {
+    bits[i] = gen_();
+  }
+  for (size_t i = 0; i < BATCH_SIZE; ++i) {
+    batch_[i] = toUniform<Engine>(bits[i]);
+  }
+  batchPosition_ = 0;
+}
 
-void NoisyTransmission::transmit(ChunkyString& message) {
-  // set up random value
-  float p = 0; // <- fix
-  for (auto j = message.begin(); j != message.end(); ++j) {
-    p = getRandomFloat();
-    if (p < errorRate_) {
+// Inverts the geometric distribution's CDF: the gap is at least k with
+// probability (1 - eventRate_)^k
+template <typename Engine>
+size_t BasicNoisyTransmission<Engine>::getGap() {
+  if (eventRate_ >= 1) {
+    return 0;
+  }
+  double gap = std::log1p(-getRandomFloat()) / logKeep_;
+  const double MAX_GAP = double(std::numeric_limits<size_t>::max() / 2);
+  return gap < MAX_GAP ? size_t(gap) : size_t(MAX_GAP);
+}
+
+// Hops from one corrupted character to the next, skipping whole chunks in
+// between, and then applies all of the changes in a single pass
+template <typename Engine>
+void BasicNoisyTransmission<Engine>::transmit(ChunkyString& message) {
+  if (eventRate_ <= 0) {
+    return;
+  }
+  ChunkyString::EditScript script;
+  size_t position = 0;
+  auto j = message.cbegin();
+  while (true) {
+    size_t gap = getGap();
+    if (gap >= message.size() - position) {
+      break;
+    }
+    position += gap;
+    j.advance(gap);
+    if (getRandomFloat() * eventRate_ < errorRate_) {
       // delete based on error rate chance
-      message.erase(j);
-    } else if (p < (2 * errorRate_)) {
-      // duplicate based on error rate chance
-      message.insert(j, *j);
+      script.push_back({ChunkyString::Edit::ERASE, position, *j});
+      ++stats_.erases_;
     } else {
-      // otherwise do nothing :)
+      // otherwise duplicate
+      script.push_back({ChunkyString::Edit::INSERT, position, *j});
+      ++stats_.inserts_;
     }
+    ++position;
+    ++j;
   }
+  message.apply(script);
+}
+
+/*
+  Walks the message one segment at a time. Everything up to the next
+  corrupted character is passed through untouched; the corrupted
+  character itself is dropped or written twice.
+*/
+template <typename Engine>
+template <typename Sink>
+void BasicNoisyTransmission<Engine>::stream(const ChunkyString& message,
+                                            Sink emit) {
+  stream(message, message.cbegin(), message.size(), emit);
+}
+
+template <typename Engine>
+template <typename Sink>
+void BasicNoisyTransmission<Engine>::stream(
+    const ChunkyString& message, ChunkyString::const_iterator first,
+    size_t count, Sink emit) {
+  size_t position = 0;  // index of the start of the current segment
+  size_t nextEvent =
+      eventRate_ > 0 ? getGap() : std::numeric_limits<size_t>::max();
+  message.forEachSegment(first, count, [&](std::string_view segment) {
+    while (nextEvent - position < segment.size()) {
+      size_t offset = nextEvent - position;
+      emit(segment.substr(0, offset));
+      if (getRandomFloat() * eventRate_ >= errorRate_) {
+        // duplicate (erasing means just not writing it)
+        emit(segment.substr(offset, 1));
+        emit(segment.substr(offset, 1));
+        ++stats_.inserts_;
+      } else {
+        ++stats_.erases_;
+      }
+      segment.remove_prefix(offset + 1);
+      position = nextEvent + 1;
+      nextEvent = position + getGap();
+    }
+    emit(segment);
+    position += segment.size();
+  });
 }
+
+template <typename Engine>
+ChunkyString BasicNoisyTransmission<Engine>::transmitted(
+    const ChunkyString& message) {
+  ChunkyString result;
+  stream(message, [&result](std::string_view piece) { result.append(piece); });
+  return result;
+}
+
+template <typename Engine>
+void BasicNoisyTransmission<Engine>::transmit(const ChunkyString& message,
+                                              std::ostream& out) {
+  stream(message, [&out](std::string_view piece) {
+    out.write(piece.data(), piece.size());
+  });
+}
+
+/*
+  Finds where each segment starts with one walk over the chunks, then lets
+  the workers claim segments in any order. Each call draws a fresh root
+  from gen_, and segment k always uses the generator seeded by
+  segmentSeed(root, k), whoever garbles it.
+*/
+template <typename Engine>
+ChunkyString BasicNoisyTransmission<Engine>::transmitParallel(
+    const ChunkyString& message, size_t threads) {
+  size_t segments = (message.size() + SEGMENT_LENGTH - 1) / SEGMENT_LENGTH;
+  std::vector<ChunkyString::const_iterator> starts;
+  starts.reserve(segments);
+  auto start = message.cbegin();
+  for (size_t k = 0; k < segments; ++k) {
+    starts.push_back(start);
+    if (k + 1 < segments) {
+      start.advance(SEGMENT_LENGTH);
+    }
+  }
+
+  uint64_t root = uint64_t(gen_()) << 32;
+  root ^= gen_();
+
+  std::vector<std::string> garbled(segments);
+  std::vector<Stats> counts(segments);
+  std::atomic<size_t> next{0};
+  auto work = [&]() {
+    for (size_t k = next++; k < segments; k = next++) {
+      size_t count =
+          std::min(SEGMENT_LENGTH, message.size() - k * SEGMENT_LENGTH);
+      BasicNoisyTransmission channel{errorRate_, segmentSeed(root, k)};
+      std::string& out = garbled[k];
+      out.reserve(count + count / 8);
+      channel.stream(message, starts[k], count,
+                     [&out](std::string_view piece) { out.append(piece); });
+      counts[k] = channel.stats();
+    }
+  };
+
+  if (threads == 0) {
+    threads = std::max(1u, std::thread::hardware_concurrency());
+  }
+  threads = std::min(threads, segments);
+  std::vector<std::thread> workers;
+  for (size_t t = 1; t < threads; ++t) {
+    workers.emplace_back(work);
+  }
+  work();
+  for (std::thread& worker : workers) {
+    worker.join();
+  }
+
+  ChunkyString result;
+  for (size_t k = 0; k < segments; ++k) {
+    result.append(garbled[k]);
+    stats_.inserts_ += counts[k].inserts_;
+    stats_.erases_ += counts[k].erases_;
+  }
+  return result;
+}
+
+template class BasicNoisyTransmission<Xoshiro256StarStar>;
+template class BasicNoisyTransmission<Pcg32>;
+template class BasicNoisyTransmission<CounterEngine>;
+template class BasicNoisyTransmission<std::mt19937>;
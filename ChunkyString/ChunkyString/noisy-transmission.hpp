@@ -11,10 +11,23 @@
 #ifndef NOISYTRANSMISSION_HPP_INCLUDED
 #define NOISYTRANSMISSION_HPP_INCLUDED 1
 
+#include <cstddef>
+#include <cstdint>
 #include <random>
 #include "chunkystring.hpp"
+#include "rng-engines.hpp"
 
-class NoisyTransmission {
+/**
+ * \class BasicNoisyTransmission
+ * \brief A noisy channel that draws its randomness from an `Engine`
+ *
+ * \details `Engine` can be any UniformRandomBitGenerator producing 32 or
+ *          64 bits; the engines in rng-engines.hpp and std::mt19937 are
+ *          compiled in noisy-transmission.cpp. Random numbers are made a
+ *          batch at a time, so the per-character work stays small.
+ */
+template <typename Engine>
+class BasicNoisyTransmission {
  public:
   /**
    * \brief Create a noisy channel with a given error rate
@@ -24,21 +37,119 @@ class NoisyTransmission {
    *          being doubled, an `errorRate` probability of being deleted,
    *          and 1 - 2 * `errorRate` probability of being left alone.
    */
-  explicit NoisyTransmission(float errorRate);
+  explicit BasicNoisyTransmission(float errorRate);
+
+  /**
+   * \brief Create a noisy channel whose random choices are determined by
+   *        `seed`, so the same message always comes out the same way
+   */
+  BasicNoisyTransmission(float errorRate, uint64_t seed);
+
+  /// Corruptions made so far by this channel
+  struct Stats {
+    size_t inserts_ = 0;  ///< Characters doubled
+    size_t erases_ = 0;   ///< Characters deleted
+  };
+
+  /// Number of characters handled as one unit by transmitParallel
+  static constexpr size_t SEGMENT_LENGTH = 1 << 16;
 
-  /// Transmit a message over the noisy channel (modifying it in-place)
+  /**
+   * \brief Transmit a message over the noisy channel (modifying it in-place)
+   *
+   * \details Rather than rolling the dice for every character, we draw
+   *          the gap to the next corrupted character from a geometric
+   *          distribution and jump straight there. The corruptions are
+   *          collected into an edit script and applied with
+   *          ChunkyString::apply.
+   */
   void transmit(ChunkyString& message);
 
+  /**
+   * \brief Transmit a copy of a message, leaving the original alone
+   *
+   * \details Reads the message a chunk at a time and writes the garbled
+   *          version into a fresh ChunkyString in one sequential pass, so
+   *          the result is perfectly packed.
+   */
+  ChunkyString transmitted(const ChunkyString& message);
+
+  /// Transmit a message straight to an output stream, in one pass
+  void transmit(const ChunkyString& message, std::ostream& out);
+
+  /**
+   * \brief Transmit a copy of a message using several threads
+   *
+   * \details The message is cut into SEGMENT_LENGTH-character segments,
+   *          and each segment is garbled with its own random-number
+   *          generator, seeded from a root drawn from this channel's
+   *          generator and the segment's index. The output therefore
+   *          depends only on the channel's seed and what it has transmitted
+   *          before, not on how many threads there are or which thread gets
+   *          which segment; calling it twice garbles the message two
+   *          different ways. The garbled segments are stitched together in
+   *          order.
+   *
+   * \param threads  number of worker threads (0 means one per core)
+   */
+  ChunkyString transmitParallel(const ChunkyString& message,
+                                size_t threads = 0);
+
+  /// Corruptions made by every transmission so far
+  const Stats& stats() const { return stats_; }
+
+  /// Start counting corruptions from zero again
+  void resetStats() { stats_ = Stats{}; }
+
  private:
+  /// Number of uniform random numbers generated at a time
+  static constexpr size_t BATCH_SIZE = 256;
+
   float errorRate_;  ///< Probability of doubling and probability of deleting
-  std::uniform_real_distribution<> dis_;  ///< Uniformly distributed floats
-  std::mt19937 gen_;                      ///< Random-number generator
+  double eventRate_;  ///< Probability of a character being changed at all
+  double logKeep_;    ///< log(1 - eventRate_), for drawing gaps
+  Engine gen_;        ///< Random-number generator
+  uint64_t seed_;  ///< Seed for gen_
+  double batch_[BATCH_SIZE];  ///< Uniform numbers in [0, 1), used in order
+  size_t batchPosition_;      ///< Next unused entry of batch_
+  Stats stats_;               ///< See stats()
 
-  /// Seed the random-number generator
+  /// Seed the random-number generator from seed_
   void seed();
 
+  /// Seed for the generator used on segment `index` by transmitParallel
+  static uint64_t segmentSeed(uint64_t seed, size_t index);
+
+  /// Refill batch_ from the engine
+  void refill();
+
   /// Get a random number
-  float getRandomFloat();
+  double getRandomFloat() {
+    if (batchPosition_ == BATCH_SIZE) {
+      refill();
+    }
+    return batch_[batchPosition_++];
+  }
+
+  /// Number of untouched characters before the next corrupted one
+  size_t getGap();
+
+  /// Garble `message` in one pass, handing each piece of output to `emit`
+  template <typename Sink>
+  void stream(const ChunkyString& message, Sink emit);
+
+  /// Garble the `count` characters starting at `first` in one pass
+  template <typename Sink>
+  void stream(const ChunkyString& message, ChunkyString::const_iterator first,
+              size_t count, Sink emit);
 };
 
+/// The usual noisy channel, using xoshiro256**
+using NoisyTransmission = BasicNoisyTransmission<Xoshiro256StarStar>;
+
+extern template class BasicNoisyTransmission<Xoshiro256StarStar>;
+extern template class BasicNoisyTransmission<Pcg32>;
+extern template class BasicNoisyTransmission<CounterEngine>;
+extern template class BasicNoisyTransmission<std::mt19937>;
+
 #endif
@@ -0,0 +1,129 @@
+/**
+ * \file rng-bench.cpp
+ *
+ * \brief Compares the random-number engines NoisyTransmission can use.
+ *
+ * \details For each engine, times making uniform doubles a batch at a time
+ *          (and, for comparison, std::uniform_real_distribution over
+ *          std::mt19937, one call per number), then times garbling a
+ *          message with `transmitted` at a low and a high noise level.
+ *
+ *          Usage: ./rngbench [megabytes]   (default 16)
+ */
+
+#include <chrono>
+#include <cstdint>
+#include <iomanip>
+#include <iostream>
+#include <random>
+#include <string>
+
+#include "chunkystring.hpp"
+#include "noisy-transmission.hpp"
+#include "rng-engines.hpp"
+
+namespace {
+
+const size_t NUMBERS = 1 << 25;  ///< Random numbers drawn per engine
+const size_t BATCH = 256;        ///< Same batch size as NoisyTransmission
+
+using Clock = std::chrono::steady_clock;
+
+double secondsSince(Clock::time_point start) {
+  return std::chrono::duration<double>(Clock::now() - start).count();
+}
+
+/// Nanoseconds per uniform double, made a batch at a time
+template <typename Engine>
+double batchedNanoseconds() {
+  Engine engine;
+  seedEngine(engine, 70);
+  typename Engine::result_type bits[BATCH];
+  double numbers[BATCH];
+  double sum = 0;
+  auto start = Clock::now();
+  for (size_t done = 0; done < NUMBERS; done += BATCH) {
+    for (size_t i = 0; i < BATCH; ++i) {
+      bits[i] = engine();
+    }
+    for (size_t i = 0; i < BATCH; ++i) {
+      numbers[i] = toUniform<Engine>(bits[i]);
+    }
+    // add up every number, so none of the conversions can be skipped
+    for (size_t i = 0; i < BATCH; ++i) {
+      sum += numbers[i];
+    }
+  }
+  double elapsed = secondsSince(start);
+  // Print nothing, but make sure the numbers are used
+  if (sum < 0) {
+    std::cout << sum;
+  }
+  return elapsed * 1e9 / NUMBERS;
+}
+
+/// Nanoseconds per uniform double, the way the original code made them
+double perCallNanoseconds() {
+  std::mt19937 engine{70};
+  std::uniform_real_distribution<> dis(0, 1);
+  double sum = 0;
+  auto start = Clock::now();
+  for (size_t i = 0; i < NUMBERS; ++i) {
+    sum += dis(engine);
+  }
+  double elapsed = secondsSince(start);
+  if (sum < 0) {
+    std::cout << sum;
+  }
+  return elapsed * 1e9 / NUMBERS;
+}
+
+/// Megabytes of message garbled per second
+template <typename Engine>
+double transmitRate(const ChunkyString& message, float noise) {
+  BasicNoisyTransmission<Engine> channel{noise, 70};
+  auto start = Clock::now();
+  ChunkyString garbled = channel.transmitted(message);
+  double elapsed = secondsSince(start);
+  if (garbled.size() == 0) {
+    std::cout << "(empty result) ";
+  }
+  return message.size() / elapsed / 1e6;
+}
+
+template <typename Engine>
+void report(const std::string& name, const ChunkyString& message) {
+  std::cout << std::left << std::setw(14) << name << std::right
+            << std::setw(10) << batchedNanoseconds<Engine>() << std::setw(12)
+            << transmitRate<Engine>(message, 0.01) << std::setw(12)
+            << transmitRate<Engine>(message, 0.1) << std::endl;
+}
+
+}  // end of anonymous namespace
+
+int main(int argc, const char* argv[]) {
+  size_t megabytes = argc > 1 ? std::stoul(argv[1]) : 16;
+
+  // A message of ordinary-looking text
+  std::mt19937 gen{1};
+  std::uniform_int_distribution<int> letters('a', 'z' + 6);
+  std::string text(megabytes << 20, ' ');
+  for (char& c : text) {
+    int letter = letters(gen);
+    c = letter > 'z' ? ' ' : char(letter);
+  }
+  ChunkyString message{text};
+
+  std::cout << std::fixed << std::setprecision(2);
+  std::cout << std::left << std::setw(14) << "engine" << std::right
+            << std::setw(10) << "ns/number" << std::setw(12) << "MB/s @1%"
+            << std::setw(12) << "MB/s @10%" << std::endl;
+  std::cout << std::left << std::setw(14) << "mt19937/call" << std::right
+            << std::setw(10) << perCallNanoseconds() << std::endl;
+  report<std::mt19937>("mt19937", message);
+  report<Xoshiro256StarStar>("xoshiro256**", message);
+  report<Pcg32>("pcg32", message);
+  report<CounterEngine>("counter", message);
+
+  return 0;
+}
@@ -0,0 +1,182 @@
+/**
+ * \file rng-engines.hpp
+ *
+ * \brief Small, fast random-number engines for NoisyTransmission, and
+ *        helpers for seeding engines and turning their output into
+ *        uniformly distributed doubles.
+ *
+ * \details All of the engines meet the standard UniformRandomBitGenerator
+ *          requirements, so they also work with the <random> distributions.
+ */
+
+#ifndef RNG_ENGINES_HPP_INCLUDED
+#define RNG_ENGINES_HPP_INCLUDED 1
+
+#include <cstdint>
+#include <limits>
+#include <random>
+#include <type_traits>
+
+/**
+ * \brief One step of splitmix64: scrambles `z` into a well-mixed value
+ *
+ * \details Used to expand a 64-bit seed into engine state, and as the
+ *          output function of CounterEngine.
+ */
+inline uint64_t splitmix64(uint64_t z) {
+  z = (z ^ (z >> 30)) * 0xbf58476d1ce4e5b9ULL;
+  z = (z ^ (z >> 27)) * 0x94d049bb133111ebULL;
+  return z ^ (z >> 31);
+}
+
+/**
+ * \class Xoshiro256StarStar
+ * \brief Blackman and Vigna's xoshiro256** generator
+ *
+ * \details 256 bits of state and a handful of shifts, rotates and adds per
+ *          64-bit output; much faster than std::mt19937.
+ */
+class Xoshiro256StarStar {
+ public:
+  using result_type = uint64_t;
+
+  /// Fill the state from `seed` with splitmix64
+  explicit Xoshiro256StarStar(uint64_t seed = 0) {
+    for (uint64_t& word : state_) {
+      seed += 0x9e3779b97f4a7c15ULL;
+      word = splitmix64(seed);
+    }
+  }
+
+  static constexpr result_type min() { return 0; }
+  static constexpr result_type max() {
+    return std::numeric_limits<result_type>::max();
+  }
+
+  result_type operator()() {
+    uint64_t result = rotl(state_[1] * 5, 7) * 9;
+    uint64_t t = state_[1] << 17;
+    state_[2] ^= state_[0];
+    state_[3] ^= state_[1];
+    state_[1] ^= state_[2];
+    state_[0] ^= state_[3];
+    state_[2] ^= t;
+    state_[3] = rotl(state_[3], 45);
+    return result;
+  }
+
+ private:
+  uint64_t state_[4];
+
+  static uint64_t rotl(uint64_t x, int k) {
+    return (x << k) | (x >> (64 - k));
+  }
+};
+
+/**
+ * \class Pcg32
+ * \brief O'Neill's PCG32 (XSH-RR output on a 64-bit LCG)
+ *
+ * \details Produces 32 bits per step from 64 bits of state.
+ */
+class Pcg32 {
+ public:
+  using result_type = uint32_t;
+
+  explicit Pcg32(uint64_t seed = 0) : state_(0) {
+    (*this)();
+    state_ += splitmix64(seed);
+    (*this)();
+  }
+
+  static constexpr result_type min() { return 0; }
+  static constexpr result_type max() {
+    return std::numeric_limits<result_type>::max();
+  }
+
+  result_type operator()() {
+    uint64_t old = state_;
+    state_ = old * 6364136223846793005ULL + INCREMENT;
+    uint32_t xorshifted = uint32_t(((old >> 18) ^ old) >> 27);
+    uint32_t rot = uint32_t(old >> 59);
+    return (xorshifted >> rot) | (xorshifted << ((32 - rot) & 31));
+  }
+
+ private:
+  static constexpr uint64_t INCREMENT = 1442695040888963407ULL;
+  uint64_t state_;
+};
+
+/**
+ * \class CounterEngine
+ * \brief Counter-based generator: the nth output is splitmix64 of
+ *        (key + n * golden ratio)
+ *
+ * \details Because each output depends only on the key and its position,
+ *          `discard(n)` is constant time, and outputs can be generated in
+ *          any order (or in parallel) with the same results.
+ */
+class CounterEngine {
+ public:
+  using result_type = uint64_t;
+
+  explicit CounterEngine(uint64_t seed = 0)
+      : key_(splitmix64(seed)), counter_(0) {
+    // Nothing else to do.
+  }
+
+  static constexpr result_type min() { return 0; }
+  static constexpr result_type max() {
+    return std::numeric_limits<result_type>::max();
+  }
+
+  result_type operator()() {
+    ++counter_;
+    return splitmix64(key_ + counter_ * 0x9e3779b97f4a7c15ULL);
+  }
+
+  /// Skip the next n outputs, in constant time
+  void discard(uint64_t n) { counter_ += n; }
+
+ private:
+  uint64_t key_;
+  uint64_t counter_;
+};
+
+/**
+ * \brief Seed any engine from a 64-bit value
+ *
+ * \details Standard engines (e.g., std::mt19937) are seeded through a
+ *          std::seed_seq so that all 64 bits count; the engines above
+ *          take the seed directly.
+ */
+template <typename Engine>
+void seedEngine(Engine& engine, uint64_t seed) {
+  if constexpr (std::is_constructible_v<Engine, std::seed_seq&>) {
+    std::seed_seq sequence{uint32_t(seed), uint32_t(seed >> 32)};
+    engine.seed(sequence);
+  } else {
+    engine = Engine{seed};
+  }
+}
+
+/**
+ * \brief Turn one engine output into a double uniformly distributed in
+ *        [0, 1)
+ *
+ * \details Uses the top 53 bits of a 64-bit output, or all of a 32-bit
+ *          one. No branches or loops, so a loop of these vectorizes.
+ */
+template <typename Engine>
+inline double toUniform(typename Engine::result_type bits) {
+  static_assert(Engine::min() == 0, "engine output must start at zero");
+  if constexpr (Engine::max() == std::numeric_limits<uint64_t>::max()) {
+    return double(uint64_t(bits) >> 11) * 0x1.0p-53;
+  } else {
+    static_assert(Engine::max() == std::numeric_limits<uint32_t>::max(),
+                  "engine must produce 32 or 64 random bits");
+    return double(uint32_t(bits)) * 0x1.0p-32;
+  }
+}
+
+#endif  // RNG_ENGINES_HPP_INCLUDED
@@ -0,0 +1,114 @@
+/**
+ * \file shared-chunkystring.cpp
+ *
+ * \brief Implements SharedChunkyString's epoch-based reclamation
+ *
+ * \details
+ *   A reader pins by reading the global epoch and storing it in its slot
+ *   *before* it loads the current version. The writer swaps in the new
+ *   version *before* bumping the epoch. So a reader that can see a version
+ *   retired in epoch e must have pinned an epoch no later than e, and it's
+ *   safe to free that version once every pinned epoch is later than e.
+ *   All of the atomic operations use the default (sequentially consistent)
+ *   ordering, which this argument relies on.
+ */
+
+#include <algorithm>
+#include <limits>
+#include <memory>
+#include <stdexcept>
+
+#include "shared-chunkystring.hpp"
+
+// ----------------------- Snapshot: ----------------------
+
+SharedChunkyString::Snapshot::Snapshot(std::atomic<uint64_t>* pin,
+                                       const ChunkyString* text)
+    : pin_{pin}, text_{text} {
+    // nothing left to do
+}
+
+// Unpinning lets the writer free any version we were looking at
+SharedChunkyString::Snapshot::~Snapshot() {
+    pin_->store(0);
+}
+
+// ----------------------- Reader: ----------------------
+
+SharedChunkyString::Reader::Reader(SharedChunkyString* owner, size_t slot)
+    : owner_{owner}, slot_{slot} {
+    // nothing left to do
+}
+
+// Gives the slot back for another thread to use
+SharedChunkyString::Reader::~Reader() {
+    owner_->slots_[slot_].pin_.store(0);
+    owner_->slots_[slot_].owned_.store(false);
+}
+
+// Publishes the epoch we're reading in, then grabs the current version
+SharedChunkyString::Snapshot SharedChunkyString::Reader::pin() {
+    std::atomic<uint64_t>& pin = owner_->slots_[slot_].pin_;
+    pin.store(owner_->epoch_.load() + 1);
+    return Snapshot{&pin, owner_->current_.load()};
+}
+
+// ----------------------- SharedChunkyString: ----------------------
+
+SharedChunkyString::SharedChunkyString(const ChunkyString& text)
+    : current_{new ChunkyString{text}}, epoch_{0}, retired_{} {
+    // nothing left to do
+}
+
+SharedChunkyString::~SharedChunkyString() {
+    delete current_.load();
+    for (const Retired& old : retired_) {
+        delete old.text_;
+    }
+}
+
+// Claims the first free slot
+SharedChunkyString::Reader SharedChunkyString::reader() {
+    for (size_t i = 0; i < MAX_READERS; ++i) {
+        bool unowned = false;
+        if (slots_[i].owned_.compare_exchange_strong(unowned, true)) {
+            return Reader{this, i};
+        }
+    }
+    throw std::runtime_error("SharedChunkyString: too many readers");
+}
+
+// Publishes a copy
+void SharedChunkyString::publish(const ChunkyString& text) {
+    publish(std::make_unique<ChunkyString>(text));
+}
+
+// Swaps in the new version and retires the old one in the current epoch
+void SharedChunkyString::publish(std::unique_ptr<ChunkyString> text) {
+    const ChunkyString* old = current_.exchange(text.release());
+    retired_.push_back(Retired{old, epoch_.fetch_add(1)});
+    reclaim();
+}
+
+// Frees every retired version from before the oldest pinned epoch
+void SharedChunkyString::reclaim() {
+    uint64_t oldest = std::numeric_limits<uint64_t>::max();
+    for (const Slot& slot : slots_) {
+        uint64_t pin = slot.pin_.load();
+        if (pin != 0) {
+            oldest = std::min(oldest, pin - 1);
+        }
+    }
+    std::vector<Retired>::iterator stillVisible = std::partition(
+        retired_.begin(), retired_.end(),
+        [oldest](const Retired& old) { return old.epoch_ >= oldest; });
+    for (std::vector<Retired>::iterator i = stillVisible; i != retired_.end();
+         ++i) {
+        delete i->text_;
+    }
+    retired_.erase(stillVisible, retired_.end());
+}
+
+size_t SharedChunkyString::retired() const {
+    return retired_.size();
+}
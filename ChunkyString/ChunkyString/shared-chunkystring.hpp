@@ -0,0 +1,154 @@
+/**
+ * \file shared-chunkystring.hpp
+ *
+ * \brief Declares SharedChunkyString, a ChunkyString that many threads can
+ *        read while one thread edits it.
+ */
+
+#ifndef SHARED_CHUNKYSTRING_HPP_INCLUDED
+#define SHARED_CHUNKYSTRING_HPP_INCLUDED 1
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <utility>
+#include <vector>
+
+#include "chunkystring.hpp"
+
+/**
+ * \class SharedChunkyString
+ * \brief A document shared between many reader threads and one writer
+ *
+ * \details
+ *   Readers never block and never see a half-finished edit. Each reader
+ *   thread gets a Reader (one slot in a fixed table), and calls `pin()` to
+ *   get a Snapshot of the current version of the document. Pinning just
+ *   records the current epoch in the reader's own slot, so readers don't
+ *   contend with each other or with the writer.
+ *
+ *   The writer edits a copy of the current version and publishes it. The
+ *   old version is retired along with the epoch at which it was replaced,
+ *   and it is freed only once every pinned reader has a later epoch, i.e.,
+ *   once no reader can possibly still be looking at it.
+ *
+ *   Each publish copies the document once, so the writer should batch
+ *   edits (e.g., with ChunkyString::apply) rather than publish every
+ *   keystroke.
+ *
+ * \remarks Only one thread may call the writer functions (`publish`,
+ *          `update` and `reclaim`) at a time.
+ */
+class SharedChunkyString {
+ public:
+  static const size_t MAX_READERS = 64;  ///< Number of reader slots
+
+  class Reader;
+
+  /**
+   * \class Snapshot
+   * \brief A pinned, read-only version of the document
+   *
+   * \details The version stays alive (and unchanged) until the Snapshot
+   *          is destroyed. A reader should hold only one at a time.
+   */
+  class Snapshot {
+   public:
+    Snapshot(const Snapshot&) = delete;
+    Snapshot& operator=(const Snapshot&) = delete;
+    ~Snapshot();
+
+    const ChunkyString& operator*() const { return *text_; }
+    const ChunkyString* operator->() const { return text_; }
+
+   private:
+    friend class Reader;
+    Snapshot(std::atomic<uint64_t>* pin, const ChunkyString* text);
+
+    std::atomic<uint64_t>* pin_;  ///< Reader slot to clear when done
+    const ChunkyString* text_;    ///< The pinned version
+  };
+
+  /**
+   * \class Reader
+   * \brief One reader thread's slot in the epoch table
+   */
+  class Reader {
+   public:
+    Reader(const Reader&) = delete;
+    Reader& operator=(const Reader&) = delete;
+    ~Reader();  ///< Gives the slot back
+
+    /// Pin the current version of the document
+    Snapshot pin();
+
+   private:
+    friend class SharedChunkyString;
+    Reader(SharedChunkyString* owner, size_t slot);
+
+    SharedChunkyString* owner_;
+    size_t slot_;
+  };
+
+  /// Start sharing a copy of `text`
+  explicit SharedChunkyString(const ChunkyString& text = ChunkyString{});
+  SharedChunkyString(const SharedChunkyString&) = delete;
+  SharedChunkyString& operator=(const SharedChunkyString&) = delete;
+
+  /// Frees every version; no Readers may still exist
+  ~SharedChunkyString();
+
+  /**
+   * \brief Claim a reader slot for the calling thread
+   *
+   * \throws std::runtime_error if all MAX_READERS slots are in use
+   */
+  Reader reader();
+
+  /// Replace the document with a copy of `text` (writer only)
+  void publish(const ChunkyString& text);
+
+  /// Replace the document with `text`, taking ownership of it (writer only)
+  void publish(std::unique_ptr<ChunkyString> text);
+
+  /**
+   * \brief Edit a copy of the current version, then publish it (writer
+   *        only)
+   *
+   * \param edit  function taking a `ChunkyString&` to modify
+   */
+  template <typename Edit>
+  void update(Edit edit) {
+    std::unique_ptr<ChunkyString> next =
+        std::make_unique<ChunkyString>(*current_.load());
+    edit(*next);
+    publish(std::move(next));
+  }
+
+  /// Free retired versions that no reader can see (writer only)
+  void reclaim();
+
+  /// Number of old versions waiting to be freed
+  size_t retired() const;
+
+ private:
+  /// A reader slot, padded so that readers don't share cache lines
+  struct alignas(64) Slot {
+    std::atomic<bool> owned_{false};  ///< Claimed by a Reader
+    std::atomic<uint64_t> pin_{0};    ///< Pinned epoch + 1, or 0 if none
+  };
+
+  /// An old version and the epoch during which it was replaced
+  struct Retired {
+    const ChunkyString* text_;
+    uint64_t epoch_;
+  };
+
+  std::atomic<const ChunkyString*> current_;  ///< Latest version
+  std::atomic<uint64_t> epoch_;               ///< Bumped by every publish
+  Slot slots_[MAX_READERS];                   ///< One per Reader
+  std::vector<Retired> retired_;              ///< Versions not yet freed
+};
+
+#endif  // SHARED_CHUNKYSTRING_HPP_INCLUDED
@@ -0,0 +1,233 @@
+/**
+ * \file string-bench.cpp
+ *
+ * \brief Runs the same workloads on ChunkyString, std::string,
+ *        std::deque<char> and std::list<char>, to show where chunking
+ *        helps and where it hurts.
+ *
+ * \details For each container and size, reports nanoseconds per
+ *          operation for
+ *            - append:  push_back, per character
+ *            - insert:  insert at a random position, per insertion
+ *            - erase:   erase at a random position, per erasure
+ *            - scan:    read every character in order, per character
+ *            - copy:    copy construction, per character
+ *            - compare: == against the copy, per character
+ *          and the peak heap bytes per character while the string was
+ *          being built (counted by replacing the global operator new).
+ *
+ *          Usage: ./stringbench [operations]   (default 1000 random
+ *          insertions and erasures per size)
+ */
+
+#include <algorithm>
+#include <chrono>
+#include <cstddef>
+#include <cstdlib>
+#include <deque>
+#include <iomanip>
+#include <iostream>
+#include <iterator>
+#include <list>
+#include <new>
+#include <random>
+#include <string>
+
+#include "chunkystring.hpp"
+
+namespace {
+
+size_t liveBytes = 0;  ///< Bytes currently allocated with operator new
+size_t peakBytes = 0;  ///< Most bytes allocated at once since last reset
+
+/// Space in front of each allocation for its size; also the alignment of
+/// ordinary allocations
+const size_t HEADER = 16;
+
+}  // end of anonymous namespace
+
+namespace {
+
+/// Allocate with room for the size in front, keeping `align` alignment
+void* countedNew(size_t bytes, size_t align) {
+  size_t header = std::max(HEADER, align);
+  size_t total = (header + bytes + align - 1) / align * align;
+  char* block = static_cast<char*>(std::aligned_alloc(align, total));
+  if (block == nullptr) {
+    throw std::bad_alloc();
+  }
+  *reinterpret_cast<size_t*>(block + header - sizeof(size_t)) = bytes;
+  liveBytes += bytes;
+  peakBytes = std::max(peakBytes, liveBytes);
+  return block + header;
+}
+
+/// Free memory from countedNew
+void countedDelete(void* p, size_t align) noexcept {
+  if (p == nullptr) {
+    return;
+  }
+  size_t header = std::max(HEADER, align);
+  char* block = static_cast<char*>(p) - header;
+  liveBytes -= *reinterpret_cast<size_t*>(block + header - sizeof(size_t));
+  std::free(block);
+}
+
+}  // end of anonymous namespace
+
+// Replacing these covers every allocation the containers make, including
+// ChunkyString's, which std::pmr makes with the align_val_t versions.
+void* operator new(size_t bytes) { return countedNew(bytes, HEADER); }
+
+void* operator new[](size_t bytes) { return countedNew(bytes, HEADER); }
+
+void* operator new(size_t bytes, std::align_val_t align) {
+  return countedNew(bytes, size_t(align));
+}
+
+void* operator new[](size_t bytes, std::align_val_t align) {
+  return countedNew(bytes, size_t(align));
+}
+
+void operator delete(void* p) noexcept { countedDelete(p, HEADER); }
+
+void operator delete[](void* p) noexcept { countedDelete(p, HEADER); }
+
+void operator delete(void* p, size_t) noexcept { countedDelete(p, HEADER); }
+
+void operator delete[](void* p, size_t) noexcept {
+  countedDelete(p, HEADER);
+}
+
+void operator delete(void* p, std::align_val_t align) noexcept {
+  countedDelete(p, size_t(align));
+}
+
+void operator delete[](void* p, std::align_val_t align) noexcept {
+  countedDelete(p, size_t(align));
+}
+
+void operator delete(void* p, size_t, std::align_val_t align) noexcept {
+  countedDelete(p, size_t(align));
+}
+
+void operator delete[](void* p, size_t, std::align_val_t align) noexcept {
+  countedDelete(p, size_t(align));
+}
+
+namespace {
+
+using Clock = std::chrono::steady_clock;
+
+/// Nanoseconds per operation, given a start time and operation count
+double nanosecondsEach(Clock::time_point start, size_t operations) {
+  std::chrono::duration<double, std::nano> elapsed = Clock::now() - start;
+  return operations > 0 ? elapsed.count() / operations : 0;
+}
+
+/// Iterator to position `index` (ChunkyString skips whole chunks)
+template <typename Container>
+typename Container::iterator at(Container& text, size_t index) {
+  return std::next(text.begin(), index);
+}
+
+ChunkyString::iterator at(ChunkyString& text, size_t index) {
+  ChunkyString::iterator i = text.begin();
+  i.advance(index);
+  return i;
+}
+
+/// One line of results
+struct Row {
+  double append, insert, erase, scan, copy, compare, bytesPerChar;
+};
+
+template <typename Container>
+Row run(size_t size, size_t operations) {
+  Row row;
+  std::mt19937 gen(size);
+
+  // append
+  size_t before = liveBytes;
+  peakBytes = liveBytes;
+  auto start = Clock::now();
+  Container text;
+  for (size_t i = 0; i < size; ++i) {
+    text.push_back(char('a' + i % 26));
+  }
+  row.append = nanosecondsEach(start, size);
+  row.bytesPerChar = double(peakBytes - before) / size;
+
+  // random insertions, then random erasures, so the size ends where it was
+  start = Clock::now();
+  for (size_t i = 0; i < operations; ++i) {
+    size_t index = std::uniform_int_distribution<size_t>(0, size + i)(gen);
+    text.insert(at(text, index), '*');
+  }
+  row.insert = nanosecondsEach(start, operations);
+  start = Clock::now();
+  for (size_t i = operations; i > 0; --i) {
+    size_t index =
+        std::uniform_int_distribution<size_t>(0, size + i - 1)(gen);
+    text.erase(at(text, index));
+  }
+  row.erase = nanosecondsEach(start, operations);
+
+  // scan
+  start = Clock::now();
+  size_t sum = 0;
+  for (char c : text) {
+    sum += c;
+  }
+  row.scan = nanosecondsEach(start, size);
+
+  // copy and compare
+  start = Clock::now();
+  Container copy{text};
+  row.copy = nanosecondsEach(start, size);
+  start = Clock::now();
+  bool same = copy == text;
+  row.compare = nanosecondsEach(start, size);
+
+  // Print nothing, but make sure the results are used
+  if (!same || sum == 0) {
+    std::cout << "(unexpected result) ";
+  }
+  return row;
+}
+
+template <typename Container>
+void report(const std::string& name, size_t size, size_t operations) {
+  Row row = run<Container>(size, operations);
+  std::cout << std::left << std::setw(14) << name << std::right
+            << std::setw(9) << size;
+  for (double value : {row.append, row.insert, row.erase, row.scan,
+                       row.copy, row.compare, row.bytesPerChar}) {
+    std::cout << std::setw(12) << value;
+  }
+  std::cout << std::endl;
+}
+
+}  // end of anonymous namespace
+
+int main(int argc, const char* argv[]) {
+  size_t operations = argc > 1 ? std::stoul(argv[1]) : 1000;
+
+  std::cout << std::fixed << std::setprecision(2);
+  std::cout << std::left << std::setw(14) << "container" << std::right
+            << std::setw(9) << "size";
+  for (const char* column : {"append", "insert", "erase", "scan", "copy",
+                             "compare", "bytes/ch"}) {
+    std::cout << std::setw(12) << column;
+  }
+  std::cout << std::endl;
+
+  for (size_t size : {size_t(1) << 10, size_t(1) << 15, size_t(1) << 20}) {
+    report<ChunkyString>("ChunkyString", size, operations);
+    report<std::string>("std::string", size, operations);
+    report<std::deque<char>>("deque<char>", size, operations);
+    report<std::list<char>>("list<char>", size, operations);
+  }
+
+  return 0;
+}
@@ -23,14 +23,25 @@ using TestingString = GenericString;
 using TestingString = ChunkyString;
 #endif
 
+#include <algorithm>
 #include <cassert>
 #include <cstddef>
 #include <cstdlib>
 #include <iostream>
+#include <memory>
+#include <memory_resource>
 #include <sstream>
 #include <stdexcept>
 #include <string>
-
+#include <thread>
+#include <utility>
+#include <vector>
+
+#include "bounded-queue.hpp"
+#include "noisy-transmission.hpp"
+#include "rng-engines.hpp"
+#include "shared-chunkystring.hpp"
+#include "utf8-chunkystring.hpp"
 #include "signal.h"
 #include "unistd.h"
 
@@ -589,6 +600,753 @@ bool customTest() {
   return log.summarize();
 }
 
+/// A memory resource that counts the allocations it hands out from the heap
+class CountingResource : public std::pmr::memory_resource {
+ public:
+  size_t allocations_ = 0;
+
+ private:
+  void* do_allocate(size_t bytes, size_t alignment) override {
+    ++allocations_;
+    return std::pmr::new_delete_resource()->allocate(bytes, alignment);
+  }
+  void do_deallocate(void* p, size_t bytes, size_t alignment) override {
+    std::pmr::new_delete_resource()->deallocate(p, bytes, alignment);
+  }
+  bool do_is_equal(const memory_resource& other) const noexcept override {
+    return this == &other;
+  }
+};
+
+bool memoryResourceTest() {
+  // Set up the TestingLogger object
+  TestingLogger log("Memory resource test");
+
+  // The arena can't fall back on the global heap, so any chunk allocated
+  // anywhere else would throw std::bad_alloc.
+  static char buffer[16384];
+  std::pmr::monotonic_buffer_resource arena{
+      buffer, sizeof(buffer), std::pmr::null_memory_resource()};
+
+  TestingString s1{&arena};
+  affirm(s1.resource() == &arena);
+
+  for (size_t i = 0; i < 100; ++i) {
+    s1.push_back('a' + i % 26);
+  }
+  s1.insert(s1.begin(), '*');
+  s1.erase(s1.begin());
+  affirm(s1.size() == 100);
+  affirm(*s1.begin() == 'a');
+
+  // copies can be placed in the arena too, or back on the default heap
+  TestingString s2{s1, &arena};
+  affirm(s2.resource() == &arena);
+  affirm(s2 == s1);
+
+  TestingString s3 = s1;
+  affirm(s3.resource() == std::pmr::get_default_resource());
+  affirm(s3 == s1);
+
+  // assignment keeps the destination's resource
+  s1 = s3;
+  affirm(s1.resource() == &arena);
+  affirm(s1 == s3);
+
+  // appending only allocates the chunks the result needs, even when
+  // appending a string to itself
+  CountingResource counting;
+  TestingString s4{&counting};
+  s4 += TestingString{std::string(10 * TESTING_CHUNKSIZE, 'c')};
+  affirm(s4.size() == 10 * TESTING_CHUNKSIZE);
+  affirm(counting.allocations_ == s4.memory_usage().chunkCount_);
+  s4 += s4;
+  affirm(s4 == std::string(20 * TESTING_CHUNKSIZE, 'c'));
+  affirm(counting.allocations_ == s4.memory_usage().chunkCount_);
+
+  // Print a summary of the all the affirmations and return true
+  // if they were all successful.
+  return log.summarize();
+}
+
+bool runChunkTest() {
+  // Set up the TestingLogger object
+  TestingLogger log("Run chunk test");
+
+  TestingString runs;
+  TestingString plain;
+  std::string control;
+
+  runs.push_back('<');
+  runs.appendRun('-', 1000);
+  runs.push_back('-');
+  runs.appendRun('=', 5);
+  runs.push_back('>');
+  control = "<" + std::string(1001, '-') + std::string(5, '=') + ">";
+  for (char c : control) {
+    plain.push_back(c);
+  }
+
+  affirm(runs.size() == control.size());
+  affirm(runs == plain);
+  // the long run takes up (a lot) less than its share of chunks
+  affirm(runs.utilization() > 1.0);
+
+  // inserting a different character expands only part of the run
+  TestingString::iterator i = runs.begin();
+  for (size_t n = 0; n < 500; ++n) {
+    ++i;
+  }
+  i = runs.insert(i, '|');
+  affirm(*i == '|');
+  control.insert(500, "|");
+  affirm(runs.size() == control.size());
+
+  // erasing from a run shrinks it
+  i = runs.begin();
+  ++i;
+  i = runs.erase(i);
+  affirm(*i == '-');
+  control.erase(1, 1);
+
+  std::stringstream out;
+  out << runs;
+  affirm(out.str() == control);
+
+  // compact turns long runs of ordinary chunks back into runs
+  plain.compact();
+  affirm(plain.size() == 1 + 1001 + 5 + 1);
+  affirm(plain.utilization() > 1.0);
+  std::stringstream plainOut;
+  plainOut << plain;
+  affirm(plainOut.str() == "<" + std::string(1001, '-') + "=====>");
+
+  // copies and assignments keep runs compressed
+  TestingString longRun;
+  longRun.appendRun('~', 1000000);
+  TestingString copied{longRun};
+  affirm(copied == longRun);
+  affirm(copied.memory_usage().chunkCount_ == 1);
+  TestingString assigned{"old"};
+  assigned = longRun;
+  affirm(assigned == longRun);
+  affirm(assigned.memory_usage().chunkCount_ == 1);
+  affirm(assigned.memory_usage().totalBytes() ==
+         longRun.memory_usage().totalBytes());
+  const TestingString& itself = assigned;
+  assigned = itself;
+  affirm(assigned.size() == 1000000);
+
+  // writing through an iterator into a run changes just that character,
+  // and iterators taken before the write still find their characters
+  TestingString written;
+  written.appendRun('a', 100);
+  TestingString::iterator before = written.begin();
+  before.advance(80);
+  TestingString::iterator w = written.begin();
+  w.advance(40);
+  *w = 'b';
+  std::string expected = std::string(40, 'a') + "b" + std::string(59, 'a');
+  affirm(written == expected);
+  affirm(*before == 'a');
+  *before = 'c';
+  expected[80] = 'c';
+  affirm(written == expected);
+  ++w;
+  affirm(*w == 'a');
+
+  // so do the standard algorithms, forwards and backwards
+  TestingString filled;
+  filled.appendRun('x', 60);
+  TestingString::iterator from = filled.begin();
+  from.advance(20);
+  TestingString::iterator to = from;
+  to.advance(5);
+  std::fill(from, to, 'y');
+  TestingString::reverse_iterator tail = filled.rbegin();
+  std::advance(tail, 10);
+  std::replace(filled.rbegin(), tail, 'x', 'z');
+  affirm(filled == std::string(20, 'x') + std::string(5, 'y') +
+                   std::string(25, 'x') + std::string(10, 'z'));
+  affirm(filled.size() == 60);
+
+  // Print a summary of the all the affirmations and return true
+  // if they were all successful.
+  return log.summarize();
+}
+
+bool applyTest() {
+  // Set up the TestingLogger object
+  TestingLogger log("Apply edit script test");
+
+  using Edit = TestingString::Edit;
+  TestingString s1;
+  std::string control = "the quick brown fox jumps over the lazy dog";
+  for (char c : control) {
+    s1.push_back(c);
+  }
+  s1.appendRun('!', 40);
+
+  TestingString::EditScript script = {
+      {Edit::INSERT, 0, '>'},   {Edit::INSERT, 0, '>'},
+      {Edit::REPLACE, 0, 'T'},  {Edit::ERASE, 3, ' '},
+      {Edit::INSERT, 9, '_'},   {Edit::ERASE, 9, ' '},
+      {Edit::REPLACE, 42, 'G'}, {Edit::ERASE, 43, '!'},
+      {Edit::INSERT, 60, '?'},  {Edit::INSERT, 83, '.'}};
+  s1.apply(script);
+
+  std::stringstream out;
+  out << s1;
+  affirm(out.str() ==
+         ">>Thequick_brown fox jumps over the lazy doG" +
+         std::string(16, '!') + "?" + std::string(23, '!') + ".");
+  affirm(s1.size() == out.str().size());
+  checkUtilization(s1, 2);
+
+  // bad scripts throw and leave the string alone
+  TestingString s2 = s1;
+  bool threw = false;
+  try {
+    s1.apply({{Edit::ERASE, 5, ' '}, {Edit::ERASE, 2, ' '}});
+  } catch (const std::invalid_argument&) {
+    threw = true;
+  }
+  affirm(threw);
+  threw = false;
+  try {
+    s1.apply({{Edit::ERASE, 5, ' '}, {Edit::REPLACE, 5, 'x'}});
+  } catch (const std::invalid_argument&) {
+    threw = true;
+  }
+  affirm(threw);
+  threw = false;
+  try {
+    s1.apply({{Edit::ERASE, s1.size(), ' '}});
+  } catch (const std::invalid_argument&) {
+    threw = true;
+  }
+  affirm(threw);
+  affirm(s1 == s2);
+
+  // an empty script changes nothing
+  s1.apply({});
+  affirm(s1 == s2);
+
+  // Print a summary of the all the affirmations and return true
+  // if they were all successful.
+  return log.summarize();
+}
+
+bool stringViewTest() {
+  // Set up the TestingLogger object
+  TestingLogger log("string_view test");
+
+  std::string text = "a string that is longer than a couple of chunks";
+  TestingString s1{text};
+  affirm(s1.size() == text.size());
+  affirm(s1 == text);
+  affirm(s1 == std::string_view{text});
+  affirm(s1.to_string() == text);
+  checkUtilization(s1, 1);
+
+  // comparisons against literals don't need a TestingString
+  TestingString s2{"abc"};
+  affirm(s2 == "abc");
+  affirm(s2 != "abd");
+  affirm(s2 != "ab");
+  affirm(s2 != "abcd");
+  affirm(s2 < "abd");
+  affirm(s2 < "abcd");
+  affirm(!(s2 < "abc"));
+  affirm(!(s2 < "ab"));
+  affirm(TestingString{} == "");
+
+  // append tops up the last chunk before starting new ones
+  s2.append("defghijklmnopqrstuvwxyz");
+  affirm(s2 == "abcdefghijklmnopqrstuvwxyz");
+  checkUtilization(s2, 1);
+
+  // run chunks convert too
+  s2.appendRun('z', 30);
+  affirm(s2.to_string() == "abcdefghijklmnopqrstuvwxyz" + std::string(30, 'z'));
+  affirm(s2 == "abcdefghijklmnopqrstuvwxyz" + std::string(30, 'z'));
+  affirm(s2 != "abcdefghijklmnopqrstuvwxyz" + std::string(29, 'z') + "!");
+
+  // Print a summary of the all the affirmations and return true
+  // if they were all successful.
+  return log.summarize();
+}
+
+bool reverseTest() {
+  // Set up the TestingLogger object
+  TestingLogger log("Reverse iterator test");
+
+  std::string text = "first line\nsecond line\nthird line, which is long";
+  TestingString s1{text};
+  s1.appendRun(' ', 20);
+
+  // reverse iteration visits the characters back to front
+  std::string backward{s1.crbegin(), s1.crend()};
+  std::string control = text + std::string(20, ' ');
+  affirm(backward == std::string(control.rbegin(), control.rend()));
+  TestingString empty;
+  affirm(empty.rbegin() == empty.rend());
+
+  // and can write through non-const reverse iterators
+  TestingString s2{"abc"};
+  *s2.rbegin() = 'C';
+  affirm(s2 == "abC");
+
+  // rfind finds the last newline...
+  TestingString::iterator newline = s1.rfind('\n');
+  affirm(newline != s1.end());
+  affirm(*newline == '\n');
+  ++newline;
+  affirm(*newline == 't');
+
+  // ...the last character of a run, and reports missing characters
+  TestingString::iterator space = s1.rfind(' ');
+  affirm(++space == s1.end());
+  affirm(s1.rfind('#') == s1.end());
+
+  // trimming trailing spaces only looks at the tail
+  const TestingString& constS1 = s1;
+  TestingString::const_iterator lastG = constS1.rfind('g');
+  size_t kept = 0;
+  for (TestingString::const_iterator i = constS1.begin(); i != lastG; ++i) {
+    ++kept;
+  }
+  affirm(kept + 1 == text.size());
+
+  // Print a summary of the all the affirmations and return true
+  // if they were all successful.
+  return log.summarize();
+}
+
+bool sharedStringTest() {
+  // Set up the TestingLogger object
+  TestingLogger log("Shared string test");
+
+  // Every version is 100 copies of one letter, so a reader that ever saw
+  // a torn or freed version would find mismatched characters.
+  SharedChunkyString shared{TestingString{std::string(100, 'a')}};
+  std::atomic<bool> done{false};
+  std::atomic<size_t> badReads{0};
+
+  std::vector<std::thread> readers;
+  for (size_t t = 0; t < 4; ++t) {
+    readers.emplace_back([&shared, &done, &badReads]() {
+      SharedChunkyString::Reader reader = shared.reader();
+      while (!done.load()) {
+        SharedChunkyString::Snapshot snapshot = reader.pin();
+        char first = *snapshot->begin();
+        for (char c : *snapshot) {
+          if (c != first) {
+            ++badReads;
+          }
+        }
+        if (snapshot->size() != 100) {
+          ++badReads;
+        }
+      }
+    });
+  }
+
+  for (size_t version = 1; version < 500; ++version) {
+    char letter = 'a' + version % 26;
+    shared.update([letter](TestingString& text) {
+      TestingString::EditScript script;
+      for (size_t i = 0; i < text.size(); ++i) {
+        script.push_back({TestingString::Edit::REPLACE, i, letter});
+      }
+      text.apply(script);
+    });
+  }
+  done = true;
+  for (std::thread& reader : readers) {
+    reader.join();
+  }
+  affirm(badReads == 0);
+
+  // with no readers left, everything old can be freed
+  shared.reclaim();
+  affirm(shared.retired() == 0);
+
+  // a pinned snapshot holds back reclamation until it's released
+  {
+    SharedChunkyString::Reader reader = shared.reader();
+    SharedChunkyString::Snapshot snapshot = reader.pin();
+    shared.publish(TestingString{"new"});
+    affirm(shared.retired() == 1);
+    affirm(*snapshot == std::string(100, 'a' + 499 % 26));
+  }
+  shared.reclaim();
+  affirm(shared.retired() == 0);
+  SharedChunkyString::Reader reader = shared.reader();
+  affirm(*reader.pin() == "new");
+
+  // publishing an owned version hands over that very object, uncopied
+  std::unique_ptr<TestingString> owned =
+      std::make_unique<TestingString>("owned");
+  const TestingString* address = owned.get();
+  shared.publish(std::move(owned));
+  affirm(&*reader.pin() == address);
+  affirm(*reader.pin() == "owned");
+
+  // Print a summary of the all the affirmations and return true
+  // if they were all successful.
+  return log.summarize();
+}
+
+bool memoryUsageTest() {
+  // Set up the TestingLogger object
+  TestingLogger log("Memory usage test");
+
+  TestingString s1{std::string(2 * TESTING_CHUNKSIZE, 'm')};
+  TestingString::MemoryUsage usage = s1.memory_usage();
+  affirm(usage.chunkCount_ == 2);
+  affirm(usage.payloadBytes_ == s1.size());
+  affirm(usage.unusedBytes_ == 0);
+  affirm(usage.metadataBytes_ > sizeof(TestingString));
+  affirm(usage.totalBytes() > usage.payloadBytes_ + usage.metadataBytes_);
+
+  // a run chunk's payload is its single character
+  s1.appendRun('-', 1000);
+  usage = s1.memory_usage();
+  affirm(usage.chunkCount_ == 3);
+  affirm(usage.payloadBytes_ == s1.size() - 999);
+
+  // an empty string is just the object itself
+  TestingString empty;
+  affirm(empty.memory_usage().totalBytes() == sizeof(TestingString));
+
+#if CHUNKYSTRING_COUNTERS
+  TestingString s2;
+  for (size_t i = 0; i < TESTING_CHUNKSIZE; ++i) {
+    s2.push_back('a');
+  }
+  affirm(s2.counters().chunkAllocations_ == 1);
+  s2.insert(s2.begin(), 'b');  // splits the full chunk
+  affirm(s2.counters().chunkAllocations_ == 2);
+  affirm(s2.counters().bytesShifted_ > 0);
+  s2.resetCounters();
+  s2.erase(s2.begin());
+  affirm(s2.counters().chunkAllocations_ == 0);
+  affirm(s2.counters().bytesShifted_ > 0);
+#else
+  affirm(s1.counters().chunkAllocations_ == 0);
+  // and the string has no room for them
+  affirm(sizeof(TestingString) ==
+         sizeof(size_t) + sizeof(std::pmr::list<char>));
+#endif
+
+  // Print a summary of the all the affirmations and return true
+  // if they were all successful.
+  return log.summarize();
+}
+
+bool utf8Test() {
+  // Set up the TestingLogger object
+  TestingLogger log("UTF-8 string test");
+
+  // "naïve café €5 😀" -- ï and é are 2 bytes, € is 3, 😀 is 4
+  std::string text = "na\xc3\xafve caf\xc3\xa9 \xe2\x82\xac" "5 "
+                     "\xf0\x9f\x98\x80";
+  Utf8ChunkyString s1{text};
+  affirm(s1.size() == text.size());
+  affirm(s1.length() == 15);
+  affirm(s1.at(2) == "\xc3\xaf");
+  affirm(s1.at(12) == "5");
+  affirm(s1.at(14) == "\xf0\x9f\x98\x80");
+  affirm(s1.byteOffset(3) == 4);
+  affirm(s1.byteOffset(s1.length()) == s1.size());
+
+  // edits are by code point and never split a sequence
+  s1.erase(2);
+  s1.insert(2, "i");
+  s1.insert(s1.length(), "!");
+  s1.erase(11, 2);
+  affirm(s1.to_string() ==
+         "naive caf\xc3\xa9  \xf0\x9f\x98\x80!");
+
+  // malformed input is rejected without changing the string
+  bool threw = false;
+  try {
+    s1.insert(0, "\xe2\x82");
+  } catch (const std::invalid_argument&) {
+    threw = true;
+  }
+  affirm(threw);
+  affirm(s1.length() == 14);
+  affirm(!Utf8ChunkyString::isValid("\x80"));
+
+  // only the shortest encoding of each code point is valid UTF-8, and
+  // surrogates and code points past U+10FFFF aren't code points at all
+  affirm(!Utf8ChunkyString::isValid("\xc0\xaf"));          // overlong '/'
+  affirm(!Utf8ChunkyString::isValid("\xc1\xbf"));          // overlong DEL
+  affirm(!Utf8ChunkyString::isValid("\xe0\x80\xaf"));      // overlong '/'
+  affirm(!Utf8ChunkyString::isValid("\xe0\x9f\xbf"));      // overlong U+7FF
+  affirm(!Utf8ChunkyString::isValid("\xed\xa0\x80"));      // U+D800
+  affirm(!Utf8ChunkyString::isValid("\xed\xbf\xbf"));      // U+DFFF
+  affirm(!Utf8ChunkyString::isValid("\xf0\x80\x80\xaf"));  // overlong '/'
+  affirm(!Utf8ChunkyString::isValid("\xf0\x8f\xbf\xbf"));  // overlong
+  affirm(!Utf8ChunkyString::isValid("\xf4\x90\x80\x80"));  // U+110000
+  affirm(!Utf8ChunkyString::isValid("\xf5\x80\x80\x80"));
+  affirm(!Utf8ChunkyString::isValid("\xf7\xbf\xbf\xbf"));
+  affirm(!Utf8ChunkyString::isValid("\xff"));
+  // the nearest valid neighbours are still fine
+  affirm(Utf8ChunkyString::isValid("\xc2\x80"));           // U+80
+  affirm(Utf8ChunkyString::isValid("\xe0\xa0\x80"));       // U+800
+  affirm(Utf8ChunkyString::isValid("\xed\x9f\xbf"));       // U+D7FF
+  affirm(Utf8ChunkyString::isValid("\xee\x80\x80"));       // U+E000
+  affirm(Utf8ChunkyString::isValid("\xf0\x90\x80\x80"));   // U+10000
+  affirm(Utf8ChunkyString::isValid("\xf4\x8f\xbf\xbf"));   // U+10FFFF
+  threw = false;
+  try {
+    s1.insert(0, "\xed\xa0\x80");
+  } catch (const std::invalid_argument&) {
+    threw = true;
+  }
+  affirm(threw);
+  affirm(s1.length() == 14);
+
+  // long strings index correctly and stay well utilized
+  Utf8ChunkyString s2;
+  std::string control;
+  for (size_t i = 0; i < 1000; ++i) {
+    s2.append(i % 2 ? "\xc3\xa9" : "e");
+    control += (i % 2 ? "\xc3\xa9" : "e");
+  }
+  affirm(s2.length() == 1000);
+  affirm(s2.byteOffset(501) == 751);
+  affirm(s2.at(501) == "\xc3\xa9");
+  s2.erase(100, 800);
+  affirm(s2.length() == 200);
+  affirm(s2.to_string() == control.substr(0, 150) + control.substr(1350));
+  affirm(s2.utilization() >= 0.5);
+
+  Utf8ChunkyString s3 = s2;
+  std::stringstream out;
+  out << s3;
+  affirm(out.str() == s2.to_string());
+
+  // long text is built, copied and spliced in a chunk at a time
+  Utf8ChunkyString s4{control};
+  affirm(s4.length() == 1000);
+  affirm(s4.to_string() == control);
+  affirm(s4.utilization() >= 0.9);
+  Utf8ChunkyString s5 = s4;
+  affirm(s5.to_string() == control);
+  s5.insert(3, control);
+  s5.insert(s5.length(), control);
+  s5.insert(0, control);
+  affirm(s5.length() == 4000);
+  affirm(s5.to_string() == control + control.substr(0, 4) + control +
+                           control.substr(4) + control);
+  affirm(s5.at(1004) == "\xc3\xa9");
+  affirm(s5.utilization() >= 0.5);
+  s4 = s5;
+  affirm(s4.to_string() == s5.to_string());
+
+  // Print a summary of the all the affirmations and return true
+  // if they were all successful.
+  return log.summarize();
+}
+
+bool advanceTest() {
+  // Set up the TestingLogger object
+  TestingLogger log("Iterator advance test");
+
+  std::string control;
+  for (size_t i = 0; i < 100; ++i) {
+    control.push_back('a' + i % 26);
+  }
+  TestingString s1{control};
+  s1.appendRun('z', 50);
+  control += std::string(50, 'z');
+
+  // every jump lands on the same character as stepping would
+  for (size_t n = 0; n < control.size(); n += 7) {
+    TestingString::const_iterator i = s1.cbegin();
+    i.advance(n);
+    affirm(*i == control[n]);
+    i.advance(control.size() - n);
+    affirm(i == s1.cend());
+  }
+  TestingString::iterator j = s1.begin();
+  j.advance(0);
+  affirm(j == s1.begin());
+  j.advance(control.size());
+  affirm(j == s1.end());
+
+  // Print a summary of the all the affirmations and return true
+  // if they were all successful.
+  return log.summarize();
+}
+
+bool segmentTest() {
+  // Set up the TestingLogger object
+  TestingLogger log("Segment visiting test");
+
+  TestingString s1{"some ordinary text to start with"};
+  s1.appendRun('.', 200);
+  s1.push_back('!');
+
+  std::string pieces;
+  size_t calls = 0;
+  s1.forEachSegment([&pieces, &calls](std::string_view piece) {
+    pieces += piece;
+    ++calls;
+  });
+  affirm(pieces == s1.to_string());
+  affirm(calls < s1.size() / 4);
+
+  // Visiting part of the string, starting partway into a run
+  std::string middle;
+  auto first = s1.cbegin();
+  first.advance(30);
+  s1.forEachSegment(first, 100, [&middle](std::string_view piece) {
+    middle += piece;
+  });
+  affirm(middle == s1.to_string().substr(30, 100));
+
+  TestingString empty;
+  empty.forEachSegment([&calls](std::string_view) { calls = 0; });
+  affirm(calls > 0);
+
+  // Print a summary of the all the affirmations and return true
+  // if they were all successful.
+  return log.summarize();
+}
+
+bool boundedQueueTest() {
+  // Set up the TestingLogger object
+  TestingLogger log("Bounded queue test");
+
+  // A fast producer and a consumer, with room for only a few items
+  const int ITEMS = 1000;
+  BoundedQueue<int> queue{3};
+  std::thread producer{[&queue]() {
+    for (int i = 0; i < ITEMS; ++i) {
+      queue.push(i);
+    }
+    queue.close();
+  }};
+
+  int expected = 0;
+  bool inOrder = true;
+  int item;
+  while (queue.pop(item)) {
+    inOrder = inOrder && item == expected;
+    ++expected;
+  }
+  producer.join();
+  affirm(inOrder);
+  affirm(expected == ITEMS);
+
+  // Closed and drained stays empty
+  item = -1;
+  affirm(!queue.pop(item));
+  affirm(item == -1);
+
+  // Print a summary of the all the affirmations and return true
+  // if they were all successful.
+  return log.summarize();
+}
+
+/// True if `Engine`'s channel garbles `message` the same way whatever the
+/// number of threads, and the same way twice from the same seed
+template <typename Engine>
+bool sameForAnyThreadCount(const TestingString& message) {
+  BasicNoisyTransmission<Engine> one{0.01, 70};
+  TestingString expected = one.transmitParallel(message, 1);
+  TestingString again = one.transmitParallel(message, 1);
+  if (expected == message || again == message) {
+    return false;  // nothing was garbled, so this proves nothing
+  }
+  // each call garbles the message a different way
+  if (again == expected) {
+    return false;
+  }
+  for (size_t threads : {2, 3, 8}) {
+    BasicNoisyTransmission<Engine> many{0.01, 70};
+    if (!(many.transmitParallel(message, threads) == expected) ||
+        !(many.transmitParallel(message, threads) == again)) {
+      return false;
+    }
+  }
+  return true;
+}
+
+bool transmitTest() {
+  // Set up the TestingLogger object
+  TestingLogger log("Noisy transmission test");
+
+  // a few segments' worth, ending in a partial segment, with a run
+  TestingString message;
+  std::string control;
+  for (size_t i = 0;
+       control.size() < 3 * NoisyTransmission::SEGMENT_LENGTH + 1000; ++i) {
+    std::string line = "line " + std::to_string(i) + " of the message\n";
+    message.append(line);
+    control += line;
+  }
+  message.appendRun('=', 5000);
+  control += std::string(5000, '=');
+
+  // every engine gives the same output from the same seed, however many
+  // threads there are
+  affirm(sameForAnyThreadCount<Xoshiro256StarStar>(message));
+  affirm(sameForAnyThreadCount<Pcg32>(message));
+  affirm(sameForAnyThreadCount<CounterEngine>(message));
+  affirm(sameForAnyThreadCount<std::mt19937>(message));
+
+  // in place, into a copy, and into a stream all garble the same way
+  NoisyTransmission inPlace{0.01, 70};
+  NoisyTransmission copying{0.01, 70};
+  NoisyTransmission streaming{0.01, 70};
+  TestingString garbled = message;
+  inPlace.transmit(garbled);
+  TestingString copy = copying.transmitted(message);
+  std::stringstream out;
+  streaming.transmit(message, out);
+  affirm(!(garbled == message));
+  affirm(copy == garbled);
+  affirm(out.str() == garbled.to_string());
+  affirm(message == control);
+  affirm(inPlace.stats().inserts_ == copying.stats().inserts_);
+  affirm(inPlace.stats().erases_ == streaming.stats().erases_);
+  affirm(garbled.size() == message.size() + inPlace.stats().inserts_ -
+                               inPlace.stats().erases_);
+
+  // a noiseless channel changes nothing
+  NoisyTransmission quiet{0.0, 70};
+  TestingString untouched = message;
+  quiet.transmit(untouched);
+  affirm(untouched == message);
+  affirm(quiet.transmitted(message) == message);
+  affirm(quiet.transmitParallel(message, 4) == message);
+  std::stringstream quietOut;
+  quiet.transmit(message, quietOut);
+  affirm(quietOut.str() == control);
+  affirm(quiet.stats().inserts_ == 0 && quiet.stats().erases_ == 0);
+
+  // an empty message stays empty
+  NoisyTransmission noisy{0.25, 70};
+  TestingString empty;
+  noisy.transmit(empty);
+  affirm(empty.size() == 0);
+  affirm(noisy.transmitted(empty).size() == 0);
+  affirm(noisy.transmitParallel(empty, 4).size() == 0);
+  std::stringstream emptyOut;
+  noisy.transmit(empty, emptyOut);
+  affirm(emptyOut.str().empty());
+
+  // Print a summary of the all the affirmations and return true
+  // if they were all successful.
+  return log.summarize();
+}
+
 //--------------------------------------------------
 //           RUNNING THE TESTS
 //--------------------------------------------------
@@ -638,6 +1396,18 @@ int main(int argc, char** argv) {
   affirm(utilizationTest());
   affirm(loopIteratorTest());
   affirm(customTest());
+  affirm(memoryResourceTest());
+  affirm(runChunkTest());
+  affirm(applyTest());
+  affirm(stringViewTest());
+  affirm(reverseTest());
+  affirm(sharedStringTest());
+  affirm(memoryUsageTest());
+  affirm(utf8Test());
+  affirm(advanceTest());
+  affirm(segmentTest());
+  affirm(boundedQueueTest());
+  affirm(transmitTest());
 
   if (alltests.summarize(true)) {
     return 0;  // Error code of 0 == Success!
@@ -0,0 +1,623 @@
+/**
+ * \file utf8-chunkystring.cpp
+ *
+ * \brief Implements Utf8ChunkyString
+ *
+ * \details
+ *   Every operation finds its chunk by walking down from the root, using
+ *   the subtree code-point counts to decide whether to go left, stop, or
+ *   go right (subtracting what it skipped). Chunks that overflow are split
+ *   and the new chunk is added to the tree by rank; chunks that empty are
+ *   removed, and neighbouring chunks that fit together are merged, so the
+ *   tree stays about as well utilized as a ChunkyString.
+ */
+
+#include <algorithm>
+#include <cstring>
+#include <ctime>
+#include <stdexcept>
+#include <stdlib.h>
+
+#include "utf8-chunkystring.hpp"
+
+namespace {
+
+/// Number of bytes in the code point starting with `lead` (0 if invalid).
+/// C0 and C1 could only start overlong encodings of ASCII, and F5 to FF
+/// would start code points beyond U+10FFFF, so they're never lead bytes.
+size_t sequenceLength(char lead) {
+    unsigned char c = static_cast<unsigned char>(lead);
+    if (c < 0x80) {
+        return 1;
+    } else if (c >= 0xC2 && c <= 0xDF) {
+        return 2;
+    } else if ((c >> 4) == 0xE) {
+        return 3;
+    } else if (c >= 0xF0 && c <= 0xF4) {
+        return 4;
+    }
+    return 0;
+}
+
+/// True if `second` may follow `lead` (Unicode Table 3-7): after E0 and
+/// F0 it must rule out overlong encodings, after ED UTF-16 surrogates, and
+/// after F4 code points beyond U+10FFFF
+bool allowedSecondByte(char lead, char second) {
+    unsigned char c = static_cast<unsigned char>(second);
+    switch (static_cast<unsigned char>(lead)) {
+        case 0xE0:
+            return c >= 0xA0 && c <= 0xBF;
+        case 0xED:
+            return c >= 0x80 && c <= 0x9F;
+        case 0xF0:
+            return c >= 0x90 && c <= 0xBF;
+        case 0xF4:
+            return c >= 0x80 && c <= 0x8F;
+        default:
+            return (c & 0xC0) == 0x80;
+    }
+}
+
+/// True for the 10xxxxxx bytes that continue a multi-byte code point
+bool isContinuation(char c) {
+    return (static_cast<unsigned char>(c) & 0xC0) == 0x80;
+}
+
+/// Number of code points in some well-formed UTF-8
+size_t countCodePoints(std::string_view utf8) {
+    return std::count_if(utf8.begin(), utf8.end(),
+                         [](char c) { return !isContinuation(c); });
+}
+
+}  // end of anonymous namespace
+
+// ----------------------- Node: ----------------------
+
+Utf8ChunkyString::Node::Node(std::string_view utf8)
+    : length_{utf8.size()},
+      codePoints_{countCodePoints(utf8)},
+      left_{nullptr},
+      right_{nullptr} {
+    std::memcpy(bytes_, utf8.data(), utf8.size());
+    update(this);
+}
+
+// Shifts the rest of the chunk along to make room
+void Utf8ChunkyString::Node::insertAt(size_t offset, std::string_view utf8) {
+    std::memmove(bytes_ + offset + utf8.size(), bytes_ + offset,
+                 length_ - offset);
+    std::memcpy(bytes_ + offset, utf8.data(), utf8.size());
+    length_ += utf8.size();
+    codePoints_ += countCodePoints(utf8);
+}
+
+// Shifts the rest of the chunk back over the erased bytes
+void Utf8ChunkyString::Node::eraseAt(size_t offset, size_t count) {
+    codePoints_ -= countCodePoints(std::string_view{bytes_ + offset, count});
+    std::memmove(bytes_ + offset, bytes_ + offset + count,
+                 length_ - offset - count);
+    length_ -= count;
+}
+
+// ----------------------- Utf8ChunkyString: ----------------------
+
+Utf8ChunkyString::Utf8ChunkyString()
+    : root_{nullptr}, seed_{static_cast<unsigned int>(time(nullptr))} {
+    // nothing left to do
+}
+
+// Packs the text into full chunks and builds the tree in one go
+Utf8ChunkyString::Utf8ChunkyString(std::string_view utf8)
+    : Utf8ChunkyString() {
+    if (!isValid(utf8)) {
+        throw std::invalid_argument("Utf8ChunkyString: malformed UTF-8");
+    }
+    std::vector<Node*> chunks;
+    pack(utf8, chunks);
+    root_ = balance(chunks, 0, chunks.size());
+}
+
+// Copies the other string's tree node for node
+Utf8ChunkyString::Utf8ChunkyString(const Utf8ChunkyString& other)
+    : Utf8ChunkyString() {
+    root_ = copy(other.root_);
+}
+
+Utf8ChunkyString& Utf8ChunkyString::operator=(const Utf8ChunkyString& other) {
+    if (this != &other) {
+        Node* copied = copy(other.root_);
+        destroy(root_);
+        root_ = copied;
+    }
+    return *this;
+}
+
+Utf8ChunkyString::~Utf8ChunkyString() {
+    destroy(root_);
+}
+
+size_t Utf8ChunkyString::size() const {
+    return bytes(root_);
+}
+
+size_t Utf8ChunkyString::length() const {
+    return codePoints(root_);
+}
+
+// Checks that every lead byte is followed by the right number of
+// continuation bytes, the first of which may be further restricted
+bool Utf8ChunkyString::isValid(std::string_view utf8) {
+    size_t i = 0;
+    while (i < utf8.size()) {
+        size_t n = sequenceLength(utf8[i]);
+        if (n == 0 || i + n > utf8.size()) {
+            return false;
+        }
+        if (n > 1 && !allowedSecondByte(utf8[i], utf8[i + 1])) {
+            return false;
+        }
+        for (size_t k = 2; k < n; ++k) {
+            if (!isContinuation(utf8[i + k])) {
+                return false;
+            }
+        }
+        i += n;
+    }
+    return true;
+}
+
+// Inserts text that would fit in a chunk one code point at a time, so it
+// can go into the chunk that's already there; longer text is spliced in
+void Utf8ChunkyString::insert(size_t index, std::string_view utf8) {
+    if (!isValid(utf8)) {
+        throw std::invalid_argument("Utf8ChunkyString: malformed UTF-8");
+    }
+    if (index > length()) {
+        throw std::out_of_range("Utf8ChunkyString: insert past the end");
+    }
+    if (utf8.size() > Node::CHUNKSIZE) {
+        splice(index, utf8);
+        return;
+    }
+    while (!utf8.empty()) {
+        size_t n = sequenceLength(utf8.front());
+        insertCodePoint(index, utf8.substr(0, n));
+        utf8.remove_prefix(n);
+        ++index;
+    }
+}
+
+void Utf8ChunkyString::append(std::string_view utf8) {
+    insert(length(), utf8);
+}
+
+void Utf8ChunkyString::erase(size_t index, size_t count) {
+    if (index > length() || count > length() - index) {
+        throw std::out_of_range("Utf8ChunkyString: erase past the end");
+    }
+    for (size_t n = 0; n < count; ++n) {
+        eraseCodePoint(index);
+    }
+}
+
+// Walks down to the chunk holding code point index
+std::string_view Utf8ChunkyString::at(size_t index) const {
+    if (index >= length()) {
+        throw std::out_of_range("Utf8ChunkyString: index past the end");
+    }
+    const Node* nd = root_;
+    while (true) {
+        size_t leftCodePoints = codePoints(nd->left_);
+        if (index < leftCodePoints) {
+            nd = nd->left_;
+        } else if (index < leftCodePoints + nd->codePoints_) {
+            size_t offset = chunkOffset(nd, index - leftCodePoints);
+            return std::string_view{nd->bytes_ + offset,
+                                    sequenceLength(nd->bytes_[offset])};
+        } else {
+            index -= leftCodePoints + nd->codePoints_;
+            nd = nd->right_;
+        }
+    }
+}
+
+// Like at, but adds up the bytes of everything we skip over
+size_t Utf8ChunkyString::byteOffset(size_t index) const {
+    if (index >= length()) {
+        if (index == length()) {
+            return size();
+        }
+        throw std::out_of_range("Utf8ChunkyString: index past the end");
+    }
+    size_t offset = 0;
+    const Node* nd = root_;
+    while (true) {
+        size_t leftCodePoints = codePoints(nd->left_);
+        if (index < leftCodePoints) {
+            nd = nd->left_;
+        } else if (index < leftCodePoints + nd->codePoints_) {
+            return offset + bytes(nd->left_) +
+                   chunkOffset(nd, index - leftCodePoints);
+        } else {
+            offset += bytes(nd->left_) + nd->length_;
+            index -= leftCodePoints + nd->codePoints_;
+            nd = nd->right_;
+        }
+    }
+}
+
+std::string Utf8ChunkyString::to_string() const {
+    std::string result;
+    result.reserve(size());
+    appendTo(root_, result);
+    return result;
+}
+
+std::ostream& Utf8ChunkyString::print(std::ostream& out) const {
+    printHelper(root_, out);
+    return out;
+}
+
+double Utf8ChunkyString::utilization() const {
+    return static_cast<double>(size()) /
+           static_cast<double>(nodes(root_) * Node::CHUNKSIZE);
+}
+
+// ------------------- Private helper functions: -------------------
+
+size_t Utf8ChunkyString::nodes(const Node* nd) {
+    return nd == nullptr ? 0 : nd->size_;
+}
+
+size_t Utf8ChunkyString::bytes(const Node* nd) {
+    return nd == nullptr ? 0 : nd->subtreeBytes_;
+}
+
+size_t Utf8ChunkyString::codePoints(const Node* nd) {
+    return nd == nullptr ? 0 : nd->subtreeCodePoints_;
+}
+
+void Utf8ChunkyString::update(Node* nd) {
+    nd->size_ = 1 + nodes(nd->left_) + nodes(nd->right_);
+    nd->subtreeBytes_ = nd->length_ + bytes(nd->left_) + bytes(nd->right_);
+    nd->subtreeCodePoints_ =
+        nd->codePoints_ + codePoints(nd->left_) + codePoints(nd->right_);
+}
+
+// Steps over index code points, one lead byte at a time
+size_t Utf8ChunkyString::chunkOffset(const Node* nd, size_t index) {
+    size_t offset = 0;
+    for (size_t n = 0; n < index; ++n) {
+        offset += sequenceLength(nd->bytes_[offset]);
+    }
+    return offset;
+}
+
+// Walks down by code points, like at
+Utf8ChunkyString::Node* Utf8ChunkyString::chunkAt(Node* nd, size_t& index,
+                                                  size_t& rank) {
+    while (true) {
+        size_t leftCodePoints = codePoints(nd->left_);
+        if (index < leftCodePoints) {
+            nd = nd->left_;
+        } else if (index < leftCodePoints + nd->codePoints_) {
+            index -= leftCodePoints;
+            rank += nodes(nd->left_);
+            return nd;
+        } else {
+            index -= leftCodePoints + nd->codePoints_;
+            rank += nodes(nd->left_) + 1;
+            nd = nd->right_;
+        }
+    }
+}
+
+// Takes as many whole code points as fit in each chunk
+void Utf8ChunkyString::pack(std::string_view utf8,
+                            std::vector<Node*>& chunks) {
+    chunks.reserve(chunks.size() + utf8.size() / Node::CHUNKSIZE + 1);
+    while (!utf8.empty()) {
+        size_t length = 0;
+        while (length < utf8.size()) {
+            size_t n = sequenceLength(utf8[length]);
+            if (length + n > Node::CHUNKSIZE) {
+                break;
+            }
+            length += n;
+        }
+        chunks.push_back(new Node{utf8.substr(0, length)});
+        utf8.remove_prefix(length);
+    }
+}
+
+// The middle chunk is the root, and each half makes a subtree
+Utf8ChunkyString::Node* Utf8ChunkyString::balance(
+    const std::vector<Node*>& chunks, size_t first, size_t last) {
+    if (first == last) {
+        return nullptr;
+    }
+    size_t middle = first + (last - first) / 2;
+    Node* nd = chunks[middle];
+    nd->left_ = balance(chunks, first, middle);
+    nd->right_ = balance(chunks, middle + 1, last);
+    update(nd);
+    return nd;
+}
+
+Utf8ChunkyString::Node* Utf8ChunkyString::copy(const Node* nd) {
+    if (nd == nullptr) {
+        return nullptr;
+    }
+    Node* copied = new Node{*nd};
+    copied->left_ = copy(nd->left_);
+    copied->right_ = copy(nd->right_);
+    return copied;
+}
+
+/*
+  Cuts the chunk at the insertion point in two, packs the text (and the
+  part of the chunk after the insertion point) into a tree of new chunks,
+  and joins it in between. The chunks either side of each seam are merged
+  if they fit together, as erase does.
+*/
+void Utf8ChunkyString::splice(size_t index, std::string_view utf8) {
+    std::vector<Node*> chunks;
+    pack(utf8, chunks);
+    size_t rank = nodes(root_);
+    if (index < length()) {
+        rank = 0;
+        Node* nd = chunkAt(root_, index, rank);
+        if (index > 0) {
+            size_t offset = chunkOffset(nd, index);
+            Node* tail = new Node{
+                std::string_view{nd->bytes_ + offset, nd->length_ - offset}};
+            nd->length_ = offset;
+            nd->codePoints_ -= tail->codePoints_;
+            refresh(root_, rank);
+            chunks.push_back(tail);
+            ++rank;
+        }
+    }
+    Node* left;
+    Node* right;
+    split(root_, rank, left, right);
+    root_ = join(join(left, balance(chunks, 0, chunks.size())), right);
+    mergeWithNext(rank + chunks.size() - 1);
+    if (rank > 0) {
+        mergeWithNext(rank - 1);
+    }
+}
+
+// Puts the code point in the right chunk; if that chunk overflows,
+// insertHelper hands back a new chunk that still needs a place in the tree
+void Utf8ChunkyString::insertCodePoint(size_t index,
+                                       std::string_view codePoint) {
+    if (root_ == nullptr) {
+        root_ = new Node{codePoint};
+        return;
+    }
+    Node* overflow = nullptr;
+    size_t rank = 0;
+    insertHelper(root_, index, codePoint, overflow, rank);
+    if (overflow != nullptr) {
+        insertNode(root_, rank, overflow);
+    }
+}
+
+/*
+  Finds the chunk for the insertion, keeping track of the chunk's rank.
+  If the code point fits, it goes straight in. If the chunk is full and
+  we're inserting at one of its ends, the code point starts a new chunk
+  (so appending text fills chunks completely); otherwise we split the
+  chunk in half at a code point boundary, and the second half becomes
+  the new chunk.
+*/
+void Utf8ChunkyString::insertHelper(Node* nd, size_t index,
+                                    std::string_view codePoint,
+                                    Node*& overflow, size_t& rank) {
+    size_t leftCodePoints = codePoints(nd->left_);
+    if (index < leftCodePoints) {
+        insertHelper(nd->left_, index, codePoint, overflow, rank);
+    } else if (index <= leftCodePoints + nd->codePoints_) {
+        rank += nodes(nd->left_);
+        size_t local = index - leftCodePoints;
+        if (nd->length_ + codePoint.size() <= Node::CHUNKSIZE) {
+            nd->insertAt(chunkOffset(nd, local), codePoint);
+        } else if (local == nd->codePoints_) {
+            overflow = new Node{codePoint};
+            ++rank;
+        } else if (local == 0) {
+            overflow = new Node{codePoint};
+        } else {
+            size_t half = chunkOffset(nd, nd->codePoints_ / 2);
+            Node* tail = new Node{
+                std::string_view{nd->bytes_ + half, nd->length_ - half}};
+            nd->length_ = half;
+            nd->codePoints_ -= tail->codePoints_;
+            if (local <= nd->codePoints_) {
+                nd->insertAt(chunkOffset(nd, local), codePoint);
+            } else {
+                tail->insertAt(chunkOffset(tail, local - nd->codePoints_),
+                               codePoint);
+                update(tail);
+            }
+            overflow = tail;
+            ++rank;
+        }
+    } else {
+        rank += nodes(nd->left_) + 1;
+        insertHelper(nd->right_, index - leftCodePoints - nd->codePoints_,
+                     codePoint, overflow, rank);
+    }
+    update(nd);
+}
+
+// Erases a code point, then merges whichever chunks are now neighbours
+void Utf8ChunkyString::eraseCodePoint(size_t index) {
+    size_t rank = 0;
+    bool removed = eraseHelper(root_, index, rank);
+    if (!removed) {
+        mergeWithNext(rank);
+    } else if (rank > 0) {
+        mergeWithNext(rank - 1);
+    }
+}
+
+// Returns true if the chunk became empty and was removed
+bool Utf8ChunkyString::eraseHelper(Node*& nd, size_t index, size_t& rank) {
+    bool removed = false;
+    size_t leftCodePoints = codePoints(nd->left_);
+    if (index < leftCodePoints) {
+        removed = eraseHelper(nd->left_, index, rank);
+    } else if (index < leftCodePoints + nd->codePoints_) {
+        rank += nodes(nd->left_);
+        size_t offset = chunkOffset(nd, index - leftCodePoints);
+        nd->eraseAt(offset, sequenceLength(nd->bytes_[offset]));
+        if (nd->length_ == 0) {
+            Node* empty = nd;
+            nd = join(nd->left_, nd->right_);
+            delete empty;
+            return true;
+        }
+    } else {
+        rank += nodes(nd->left_) + 1;
+        removed = eraseHelper(nd->right_,
+                              index - leftCodePoints - nd->codePoints_, rank);
+    }
+    update(nd);
+    return removed;
+}
+
+// Moves the next chunk's contents into this one if they fit together
+void Utf8ChunkyString::mergeWithNext(size_t rank) {
+    if (rank + 1 >= nodes(root_)) {
+        return;
+    }
+    Node* nd = nodeAt(root_, rank);
+    Node* next = nodeAt(root_, rank + 1);
+    if (nd->length_ + next->length_ > Node::CHUNKSIZE) {
+        return;
+    }
+    nd->insertAt(nd->length_, std::string_view{next->bytes_, next->length_});
+    removeNode(root_, rank + 1);
+    refresh(root_, rank);
+}
+
+// Randomized insertion: the new node becomes the root of this subtree
+// with probability 1/(size + 1), just like TreeStringSet::insertHelper
+void Utf8ChunkyString::insertNode(Node*& nd, size_t rank, Node* newNode) {
+    if (nd == nullptr || rand_r(&seed_) % (nd->size_ + 1) == 0) {
+        split(nd, rank, newNode->left_, newNode->right_);
+        update(newNode);
+        nd = newNode;
+        return;
+    }
+    size_t leftNodes = nodes(nd->left_);
+    if (rank <= leftNodes) {
+        insertNode(nd->left_, rank, newNode);
+    } else {
+        insertNode(nd->right_, rank - leftNodes - 1, newNode);
+    }
+    update(nd);
+}
+
+// Removes (and frees) the chunk with the given rank
+void Utf8ChunkyString::removeNode(Node*& nd, size_t rank) {
+    size_t leftNodes = nodes(nd->left_);
+    if (rank < leftNodes) {
+        removeNode(nd->left_, rank);
+    } else if (rank == leftNodes) {
+        Node* gone = nd;
+        nd = join(nd->left_, nd->right_);
+        delete gone;
+        return;
+    } else {
+        removeNode(nd->right_, rank - leftNodes - 1);
+    }
+    update(nd);
+}
+
+// Splits a subtree into its first `rank` chunks and the rest
+void Utf8ChunkyString::split(Node* nd, size_t rank, Node*& left,
+                             Node*& right) {
+    if (nd == nullptr) {
+        left = nullptr;
+        right = nullptr;
+        return;
+    }
+    size_t leftNodes = nodes(nd->left_);
+    if (rank <= leftNodes) {
+        split(nd->left_, rank, left, nd->left_);
+        right = nd;
+    } else {
+        split(nd->right_, rank - leftNodes - 1, nd->right_, right);
+        left = nd;
+    }
+    update(nd);
+}
+
+// Joins two subtrees (all of left comes first), picking each root with
+// probability proportional to its subtree's size
+Utf8ChunkyString::Node* Utf8ChunkyString::join(Node* left, Node* right) {
+    if (left == nullptr) {
+        return right;
+    }
+    if (right == nullptr) {
+        return left;
+    }
+    if (rand_r(&seed_) % (left->size_ + right->size_) < left->size_) {
+        left->right_ = join(left->right_, right);
+        update(left);
+        return left;
+    }
+    right->left_ = join(left, right->left_);
+    update(right);
+    return right;
+}
+
+Utf8ChunkyString::Node* Utf8ChunkyString::nodeAt(Node* nd, size_t rank) {
+    while (rank != nodes(nd->left_)) {
+        if (rank < nodes(nd->left_)) {
+            nd = nd->left_;
+        } else {
+            rank -= nodes(nd->left_) + 1;
+            nd = nd->right_;
+        }
+    }
+    return nd;
+}
+
+// Recomputes the totals on the path down to the chunk with this rank
+void Utf8ChunkyString::refresh(Node* nd, size_t rank) {
+    size_t leftNodes = nodes(nd->left_);
+    if (rank < leftNodes) {
+        refresh(nd->left_, rank);
+    } else if (rank > leftNodes) {
+        refresh(nd->right_, rank - leftNodes - 1);
+    }
+    update(nd);
+}
+
+void Utf8ChunkyString::destroy(Node* nd) {
+    if (nd != nullptr) {
+        destroy(nd->left_);
+        destroy(nd->right_);
+        delete nd;
+    }
+}
+
+void Utf8ChunkyString::appendTo(const Node* nd, std::string& out) {
+    if (nd != nullptr) {
+        appendTo(nd->left_, out);
+        out.append(nd->bytes_, nd->length_);
+        appendTo(nd->right_, out);
+    }
+}
+
+void Utf8ChunkyString::printHelper(const Node* nd, std::ostream& out) {
+    if (nd != nullptr) {
+        printHelper(nd->left_, out);
+        out.write(nd->bytes_, nd->length_);
+        printHelper(nd->right_, out);
+    }
+}
@@ -0,0 +1,177 @@
+/**
+ * \file utf8-chunkystring.hpp
+ *
+ * \brief Declares Utf8ChunkyString, a chunked string of UTF-8 text indexed
+ *        by code point.
+ */
+
+#ifndef UTF8_CHUNKYSTRING_HPP_INCLUDED
+#define UTF8_CHUNKYSTRING_HPP_INCLUDED 1
+
+#include <cstddef>
+#include <iostream>
+#include <string>
+#include <string_view>
+#include <vector>
+
+/**
+ * \class Utf8ChunkyString
+ * \brief Chunked UTF-8 text where positions count code points, not bytes
+ *
+ * \details
+ *   Like ChunkyString, the text is stored in small chunks, but a chunk only
+ *   ever holds whole code points, so no edit can split a multi-byte
+ *   sequence. Each chunk knows how many code points it holds, and the
+ *   chunks live in a randomized binary search tree ordered by position
+ *   (the same kind of tree as TreeStringSet), where every node also knows
+ *   the number of chunks, bytes and code points in its subtree. That makes
+ *   finding code point `i` an expected O(log n) walk down the tree.
+ *
+ *   Building, copying and inserting long text don't go one code point at a
+ *   time: the text is packed into full chunks, which are made into a
+ *   balanced tree in one pass and joined into place.
+ *
+ *   Anything passed in must be well-formed UTF-8 (in the sense of
+ *   `isValid`); otherwise std::invalid_argument is thrown and the string
+ *   is left unchanged.
+ */
+class Utf8ChunkyString {
+ public:
+  Utf8ChunkyString();  ///< Empty string
+
+  /// String holding a copy of `utf8`
+  explicit Utf8ChunkyString(std::string_view utf8);
+
+  Utf8ChunkyString(const Utf8ChunkyString& other);
+  Utf8ChunkyString& operator=(const Utf8ChunkyString& other);
+  ~Utf8ChunkyString();
+
+  size_t size() const;    ///< Length in bytes \note constant time
+  size_t length() const;  ///< Length in code points \note constant time
+
+  /**
+   * \brief Insert text before code point `index`
+   *
+   * \param index   code point position; `length()` appends
+   * \param utf8    text to insert
+   *
+   * \note expected O(log n) per inserted code point for text that fits in
+   *       a chunk; longer text takes O(m + log n) for m bytes
+   */
+  void insert(size_t index, std::string_view utf8);
+
+  /// Append text to the end of the string
+  void append(std::string_view utf8);
+
+  /**
+   * \brief Erase `count` code points, starting with code point `index`
+   *
+   * \throws std::out_of_range if there aren't that many code points
+   *
+   * \note expected O(log n) per erased code point
+   */
+  void erase(size_t index, size_t count = 1);
+
+  /**
+   * \brief The bytes of code point `index`
+   *
+   * \warning the view is only good until the string is next modified
+   *
+   * \note expected O(log n)
+   */
+  std::string_view at(size_t index) const;
+
+  /// Byte offset of code point `index` in the whole string \note O(log n)
+  size_t byteOffset(size_t index) const;
+
+  std::string to_string() const;                 ///< Copy out the text
+  std::ostream& print(std::ostream& out) const;  ///< String printing
+
+  /// Fraction of chunk bytes in use (see ChunkyString::utilization)
+  double utilization() const;
+
+  /// True if `utf8` is a sequence of well-formed 1-4 byte code points
+  static bool isValid(std::string_view utf8);
+
+ private:
+  /**
+   * \struct Node
+   * \brief One chunk of whole code points, plus its place in the tree
+   */
+  struct Node {
+    static const size_t CHUNKSIZE = 32;  ///< Bytes per chunk
+
+    char bytes_[CHUNKSIZE];  ///< Contents of this chunk
+    size_t length_;          ///< Bytes in this chunk
+    size_t codePoints_;      ///< Code points in this chunk
+    Node* left_;
+    Node* right_;
+    size_t size_;               ///< Nodes in this subtree
+    size_t subtreeBytes_;       ///< Bytes in this subtree
+    size_t subtreeCodePoints_;  ///< Code points in this subtree
+
+    explicit Node(std::string_view utf8);
+
+    /// Insert whole code points at byte `offset` (they must fit)
+    void insertAt(size_t offset, std::string_view utf8);
+
+    /// Remove `count` bytes of whole code points at byte `offset`
+    void eraseAt(size_t offset, size_t count);
+  };
+
+  Node* root_;
+  unsigned int seed_;  ///< Seed of our random number generator
+
+  // Subtree totals, treating nullptr as an empty tree
+  static size_t nodes(const Node* nd);
+  static size_t bytes(const Node* nd);
+  static size_t codePoints(const Node* nd);
+  static void update(Node* nd);  ///< Recompute nd's subtree totals
+
+  // Offset of the index'th code point within a single chunk
+  static size_t chunkOffset(const Node* nd, size_t index);
+
+  /// The chunk holding code point `index`, which becomes the code point's
+  /// index in that chunk; adds the chunks before it to `rank`
+  static Node* chunkAt(Node* nd, size_t& index, size_t& rank);
+
+  /// Cut well-formed `utf8` into full chunks, appending them to `chunks`
+  static void pack(std::string_view utf8, std::vector<Node*>& chunks);
+
+  /// Make chunks [first, last) into a balanced tree, in order
+  static Node* balance(const std::vector<Node*>& chunks, size_t first,
+                       size_t last);
+
+  /// A copy of a subtree, with the same shape
+  static Node* copy(const Node* nd);
+
+  /// Put long text in at code point `index` as a tree of its own
+  void splice(size_t index, std::string_view utf8);
+
+  void insertCodePoint(size_t index, std::string_view codePoint);
+  void insertHelper(Node* nd, size_t index, std::string_view codePoint,
+                    Node*& overflow, size_t& rank);
+  void eraseCodePoint(size_t index);
+  bool eraseHelper(Node*& nd, size_t index, size_t& rank);
+  void mergeWithNext(size_t rank);
+
+  // Randomized-BST operations on chunk ranks
+  void insertNode(Node*& nd, size_t rank, Node* newNode);
+  void removeNode(Node*& nd, size_t rank);
+  static void split(Node* nd, size_t rank, Node*& left, Node*& right);
+  Node* join(Node* left, Node* right);
+  static Node* nodeAt(Node* nd, size_t rank);
+  static void refresh(Node* nd, size_t rank);
+
+  static void destroy(Node* nd);
+  static void appendTo(const Node* nd, std::string& out);
+  static void printHelper(const Node* nd, std::ostream& out);
+};
+
+/// Print operator for Utf8ChunkyString
+inline std::ostream& operator<<(std::ostream& out,
+                                const Utf8ChunkyString& text) {
+  return text.print(out);
+}
+
+#endif  // UTF8_CHUNKYSTRING_HPP_INCLUDED
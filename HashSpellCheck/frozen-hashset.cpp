@@ -0,0 +1,260 @@
+/**
+ * \file frozen-hashset.cpp
+ *
+ * \brief Implements FrozenHashSet, a set of strings using a minimal perfect
+ *        hash
+ */
+
+#include "frozen-hashset.hpp"
+
+#include <algorithm>
+#include <cstring>
+#include <limits>
+#include <stdexcept>
+#include <utility>
+
+#include "hash-mixing.hpp"
+
+using std::string;
+using std::string_view;
+
+// default constructor
+FrozenHashSet::FrozenHashSet()
+    : seed_{0}, size_{0}, hasEmptyWord_{false}, maximal_{0} {
+    // Nothing else to do.
+}
+
+// reads a word from each line
+FrozenHashSet::FrozenHashSet(std::istream& words)
+    : FrozenHashSet([&words]() {
+          std::vector<string> lines;
+          string line;
+          while (getline(words, line)) {
+              lines.push_back(std::move(line));
+          }
+          return lines;
+      }()) {
+    // Nothing else to do.
+}
+
+// removes duplicates and the empty word (which sorts first), then tries
+// seeds until one hashes every word differently and places every bucket,
+// which almost always means the first one
+FrozenHashSet::FrozenHashSet(std::vector<string> words) : FrozenHashSet() {
+    std::sort(words.begin(), words.end());
+    words.erase(std::unique(words.begin(), words.end()), words.end());
+    size_ = words.size();
+    if (!words.empty() && words.front().empty()) {
+        hasEmptyWord_ = true;
+        words.erase(words.begin());
+    }
+    while (!build(words)) {
+        ++seed_;
+    }
+}
+
+// returns the number of words, one per slot
+size_t FrozenHashSet::size() const {
+    return size_;
+}
+
+// reads eight bytes at a time; each step is a bijection, so words of the
+// same length that differ in one eight-byte chunk never collide, and the
+// final mix makes every bit of the result depend on every byte
+size_t FrozenHashSet::hashWord(string_view word, uint64_t seed) {
+    const uint64_t MULTIPLIER = 0x9e3779b97f4a7c15ULL;
+    uint64_t hv = ((seed + 1) * MULTIPLIER) ^ word.size();
+    const char* bytes = word.data();
+    size_t left = word.size();
+    for (; left >= sizeof(uint64_t); left -= sizeof(uint64_t)) {
+        uint64_t chunk;
+        std::memcpy(&chunk, bytes, sizeof(uint64_t));
+        bytes += sizeof(uint64_t);
+        hv = (hv ^ chunk) * MULTIPLIER;
+    }
+    // the last few bytes are shifted in one at a time, since a memcpy of
+    // a length that isn't known ahead of time is a function call
+    if (left > 0) {
+        uint64_t chunk = 0;
+        for (size_t i = 0; i < left; ++i) {
+            chunk |= uint64_t(static_cast<unsigned char>(bytes[i])) << (8 * i);
+        }
+        hv = (hv ^ chunk) * MULTIPLIER;
+    }
+    return mixHash(hv);
+}
+
+// the bucket for a word with hash hv, from its low 32 bits. Multiplying and
+// keeping the top half maps them onto the buckets without dividing.
+size_t FrozenHashSet::bucket(size_t hv) const {
+    return (uint64_t(uint32_t(hv)) * displacements_.size()) >> 32;
+}
+
+// each displacement adds a different multiple of the golden ratio to the
+// hash, and remixes it, so each one sends the bucket's words to unrelated
+// slots; the top 32 bits then pick the slot like bucket() does
+size_t FrozenHashSet::slot(size_t hv, uint32_t displacement) const {
+    uint64_t mixed = mixHash(hv + (displacement + 1) * 0x9e3779b97f4a7c15ULL);
+    return ((mixed >> 32) * lengths_.size()) >> 32;
+}
+
+// places buckets, biggest first, while there's still plenty of room, and
+// then lays out the words in slot order
+bool FrozenHashSet::build(const std::vector<string>& words) {
+    size_t count = words.size();
+    if (count == 0) {
+        return true;
+    }
+    if (count > std::numeric_limits<uint32_t>::max() / 2) {
+        throw std::length_error("FrozenHashSet: too many words");
+    }
+    for (const string& word : words) {
+        if (word.size() > std::numeric_limits<uint8_t>::max()) {
+            throw std::length_error("FrozenHashSet: word too long");
+        }
+    }
+
+    // two words with the same hash would always go to the same slot
+    std::vector<size_t> hashes(count);
+    for (size_t i = 0; i < count; ++i) {
+        hashes[i] = hashWord(words[i], seed_);
+    }
+    std::vector<size_t> sorted = hashes;
+    std::sort(sorted.begin(), sorted.end());
+    if (std::adjacent_find(sorted.begin(), sorted.end()) != sorted.end()) {
+        return false;
+    }
+
+    // setting up lengths_ first gives slot() the right size
+    size_t slotCount = count + count / SPARE_SLOTS + 1;
+    lengths_.assign(slotCount, 0);
+    displacements_.assign((count + BUCKET_SIZE - 1) / BUCKET_SIZE, 0);
+    std::vector<std::vector<uint32_t>> buckets(displacements_.size());
+    for (size_t i = 0; i < count; ++i) {
+        buckets[bucket(hashes[i])].push_back(uint32_t(i));
+    }
+    std::vector<uint32_t> order(buckets.size());
+    for (size_t b = 0; b < order.size(); ++b) {
+        order[b] = uint32_t(b);
+    }
+    std::stable_sort(order.begin(), order.end(),
+                     [&buckets](uint32_t lhs, uint32_t rhs) {
+                         return buckets[lhs].size() > buckets[rhs].size();
+                     });
+
+    std::vector<bool> taken(slotCount, false);
+    std::vector<uint32_t> wordAt(slotCount);
+    std::vector<size_t> chosen;
+    maximal_ = 0;
+    for (uint32_t b : order) {
+        const std::vector<uint32_t>& bucket = buckets[b];
+        if (bucket.empty()) {
+            break;  // the rest are empty too
+        }
+        // try displacements until every word in the bucket lands in a
+        // free slot, and no two of them land in the same one; if none of
+        // them do, the caller tries another seed
+        for (uint32_t displacement = 0; ; ++displacement) {
+            if (displacement > MAX_DISPLACEMENT) {
+                return false;
+            }
+            chosen.clear();
+            for (uint32_t i : bucket) {
+                size_t s = slot(hashes[i], displacement);
+                if (taken[s] || std::find(chosen.begin(), chosen.end(), s) !=
+                                    chosen.end()) {
+                    break;
+                }
+                chosen.push_back(s);
+            }
+            if (chosen.size() == bucket.size()) {
+                for (size_t k = 0; k < chosen.size(); ++k) {
+                    taken[chosen[k]] = true;
+                    wordAt[chosen[k]] = bucket[k];
+                }
+                displacements_[b] = uint16_t(displacement);
+                maximal_ = std::max(maximal_, size_t(displacement) + 1);
+                break;
+            }
+        }
+    }
+
+    // copy the words into one string, in slot order, noting where each
+    // group of slots starts
+    size_t length = 0;
+    for (const string& word : words) {
+        length += word.size();
+    }
+    if (length > std::numeric_limits<uint32_t>::max()) {
+        throw std::length_error("FrozenHashSet: words too long");
+    }
+    words_.clear();
+    words_.reserve(length);
+    starts_.clear();
+    starts_.reserve((slotCount + GROUP_SIZE - 1) / GROUP_SIZE);
+    for (size_t s = 0; s < slotCount; ++s) {
+        if (s % GROUP_SIZE == 0) {
+            starts_.push_back(uint32_t(words_.size()));
+        }
+        if (taken[s]) {
+            const string& word = words[wordAt[s]];
+            lengths_[s] = uint8_t(word.size());
+            words_ += word;
+        }
+    }
+    return true;
+}
+
+// the only word that could be word is the one in its slot, which starts
+// after the words in the slots before it in its group
+bool FrozenHashSet::exists(string_view word) const {
+    if (word.empty()) {
+        return hasEmptyWord_;
+    }
+    if (lengths_.empty()) {
+        return false;
+    }
+    size_t hv = hashWord(word, seed_);
+    size_t s = slot(hv, displacements_[bucket(hv)]);
+    if (lengths_[s] != word.size()) {
+        return false;
+    }
+    size_t first = s - s % GROUP_SIZE;
+    size_t start = starts_[first / GROUP_SIZE];
+    for (size_t i = first; i < s; ++i) {
+        start += lengths_[i];
+    }
+    return word == string_view(words_).substr(start, lengths_[s]);
+}
+
+// return the number of buckets
+size_t FrozenHashSet::buckets() const {
+    return displacements_.size();
+}
+
+// return the number of slots
+size_t FrozenHashSet::slots() const {
+    return lengths_.size();
+}
+
+// return the largest displacement, plus one
+size_t FrozenHashSet::maximal() const {
+    return maximal_;
+}
+
+// add up the tables and the words
+size_t FrozenHashSet::bytes() const {
+    return displacements_.size() * sizeof(uint16_t) + lengths_.size() +
+           starts_.size() * sizeof(uint32_t) + words_.size();
+}
+
+// displays the statistics of the hash table
+std::ostream& FrozenHashSet::showStatistics(std::ostream& out) const {
+    out << "Statistics:" << std::endl;
+    out << "             Size: " << size() << std::endl;
+    out << "          Buckets: " << buckets() << std::endl;
+    out << "            Slots: " << slots() << std::endl;
+    out << "            Bytes: " << bytes() << std::endl;
+    out << " Max displacement: " << maximal() << std::endl;
+    return out;
+}
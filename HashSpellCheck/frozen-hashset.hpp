@@ -0,0 +1,130 @@
+/**
+ * \file frozen-hashset.hpp
+ *
+ * \brief Provides FrozenHashSet, a set of strings that is built once and
+ *        never changes, using a minimal perfect hash
+ */
+
+#ifndef FROZEN_HASHSET_HPP_INCLUDED
+#define FROZEN_HASHSET_HPP_INCLUDED 1
+
+// The spell checker's dictionary never changes once it's loaded, so it
+// doesn't need to leave room for more elements or cope with collisions. A
+// FrozenHashSet is given all its words up front and finds a hash function
+// that sends each of them to a different slot, with only about 3% more
+// slots than words (a "perfect hash"). Looking up a word then takes one
+// hash, one read from a small table, and one string comparison.
+//
+// The hash function is built using "hash and displace" (CHD): words are
+// first hashed into buckets of about four, and then, biggest bucket first,
+// each bucket gets a displacement, the first number that, mixed into its
+// words' hashes, sends them all to slots nobody has taken yet. The spare
+// slots mean the last buckets still find free slots in a few dozen tries.
+// Only the displacements need storing: two bytes per bucket, about half a
+// byte per word.
+//
+// The words themselves are stored one after another in a single string,
+// in slot order, with a one-byte length for each slot and the position of
+// every sixteenth slot's word, so memory use is close to the size of the
+// dictionary file. Words can be at most 255 characters long.
+
+#include <cstddef>
+#include <cstdint>
+#include <iostream>
+#include <string>
+#include <string_view>
+#include <vector>
+
+class FrozenHashSet {
+ public:
+    // Makes an empty set
+    FrozenHashSet();
+
+    // Makes a set from a stream with one word per line
+    explicit FrozenHashSet(std::istream& words);
+
+    // Makes a set from the given words (duplicates are fine); throws
+    // std::length_error if a word is longer than 255 characters
+    explicit FrozenHashSet(std::vector<std::string> words);
+
+    // Makes a set from the words from first to last
+    template <typename InputIt>
+    FrozenHashSet(InputIt first, InputIt last);
+
+    ~FrozenHashSet() = default;
+    // No assignment operator or copy constructor
+    FrozenHashSet(const FrozenHashSet&) = delete;
+    FrozenHashSet operator=(const FrozenHashSet&) = delete;
+
+    // returns the number of words in the set
+    size_t size() const;
+
+    // returns true if the word is in the set. Takes anything that can be
+    // viewed as a string, so looking up a string_view or a literal doesn't
+    // copy it.
+    bool exists(std::string_view word) const;
+
+    // returns the number of buckets (displacements)
+    size_t buckets() const;
+
+    // returns the number of slots, including the empty ones
+    size_t slots() const;
+
+    // returns the largest displacement any bucket needed, plus one
+    size_t maximal() const;
+
+    // returns the number of bytes used by the set's tables and words
+    size_t bytes() const;
+
+    // prints all the relevant statistics about the hash table
+    std::ostream& showStatistics(std::ostream& out) const;
+
+ private:
+    // average number of words per bucket
+    static const size_t BUCKET_SIZE = 4;
+
+    // one slot in SPARE_SLOTS is left empty
+    static const size_t SPARE_SLOTS = 32;
+
+    // displacements are tried up to this before picking another seed
+    static const uint32_t MAX_DISPLACEMENT = UINT16_MAX;
+
+    // number of slots whose words' position is stored in one entry of
+    // starts_
+    static const size_t GROUP_SIZE = 16;
+
+    // hashes a word, with a seed so that two words that hash the same way
+    // with one seed can be told apart by picking another
+    static size_t hashWord(std::string_view word, uint64_t seed);
+
+    // the bucket for a word with hash hv
+    size_t bucket(size_t hv) const;
+
+    // the slot for a word with hash hv in a bucket with the given
+    // displacement
+    size_t slot(size_t hv, uint32_t displacement) const;
+
+    // tries to build the tables for a list of different, non-empty words
+    // using seed_, returning false if two of them hash the same way or a
+    // bucket can't be placed
+    bool build(const std::vector<std::string>& words);
+
+    uint64_t seed_;       // seed for hashWord
+    size_t size_;         // number of words, including the empty word
+    bool hasEmptyWord_;   // whether "" is in the set (it has no slot)
+    size_t maximal_;      // largest displacement, plus one
+    std::vector<uint16_t> displacements_;  // one per bucket
+    std::vector<uint8_t> lengths_;  // length of each slot's word (0 if
+                                    // the slot is empty)
+    std::vector<uint32_t> starts_;  // where the word in every GROUP_SIZEth
+                                    // slot starts in words_
+    std::string words_;             // every word, in slot order
+};
+
+template <typename InputIt>
+FrozenHashSet::FrozenHashSet(InputIt first, InputIt last)
+    : FrozenHashSet(std::vector<std::string>(first, last)) {
+    // Nothing else to do.
+}
+
+#endif  // FROZEN_HASHSET_HPP_INCLUDED
@@ -0,0 +1,31 @@
+/**
+ * \file hash-functors.hpp
+ *
+ * \brief Provides MyHash, the default hash function object for the hash-set
+ *        class templates
+ */
+
+#ifndef HASH_FUNCTORS_HPP_INCLUDED
+#define HASH_FUNCTORS_HPP_INCLUDED 1
+
+#include <cstddef>
+
+/**
+ * \brief Hashes a key by calling `myhash(key)`
+ *
+ * \details
+ *   This is what the hash sets did before they took a Hash parameter, and
+ *   it has the same catch: for a type like std::string, `myhash` must be
+ *   declared before this header is included, because argument-dependent
+ *   lookup only searches namespace std. Code that wants to include headers
+ *   in any order should pass a hash function object instead (e.g.,
+ *   StringHash from stringhash.hpp).
+ */
+struct MyHash {
+  template <typename K>
+  size_t operator()(const K& key) const {
+    return myhash(key);
+  }
+};
+
+#endif  // HASH_FUNCTORS_HPP_INCLUDED
@@ -0,0 +1,37 @@
+/**
+ * \file hash-mixing.hpp
+ *
+ * \brief Scrambles hash values so that hash tables with a power-of-two
+ *        number of buckets can pick a bucket with a mask
+ */
+
+#ifndef HASH_MIXING_HPP_INCLUDED
+#define HASH_MIXING_HPP_INCLUDED 1
+
+#include <cstddef>
+#include <cstdint>
+
+/**
+ * \param hv    Hash value from a (possibly weak) hash function.
+ * \returns     A value in which every bit depends on every bit of hv.
+ *
+ * \details
+ *   Masking off the low bits of a hash keeps only what the low bits of
+ *   the hash say, and for cheap string hashes like `hash1` in
+ *   stringhash.cpp (which multiplies by 37) they don't say much: strings
+ *   that differ only in their first characters can end up in the same
+ *   bucket. This is the finalizer from MurmurHash3 (two multiplies and
+ *   three xor-shifts), which fixes that, and is still cheaper than
+ *   dividing by a bucket count that isn't a power of two.
+ */
+inline size_t mixHash(size_t hv) {
+  uint64_t h = hv;
+  h ^= h >> 33;
+  h *= 0xff51afd7ed558ccdULL;
+  h ^= h >> 33;
+  h *= 0xc4ceb9fe1a85ec53ULL;
+  h ^= h >> 33;
+  return size_t(h);
+}
+
+#endif  // HASH_MIXING_HPP_INCLUDED
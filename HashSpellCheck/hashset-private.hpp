@@ -13,50 +13,143 @@
 
 // Includes required for your templated code go here
 #include "hashset.hpp"
+#include <functional>
 #include <iostream>
+#include <iterator>
+#include <type_traits>
+#include <utility>
 #include <vector>
 
 // Templated code for member functions goes here
 
 // default constructor
-template <typename T>
-HashSet<T>::HashSet() : hashTable_{new std::vector<T>[INITIAL_BUCKETS]} {
+template <typename T, typename Hash, typename KeyEqual>
+HashSet<T, Hash, KeyEqual>::HashSet() : HashSet(false) {
+    // Nothing else to do.
+}
+
+// constructor choosing whether to grow incrementally, and the hash and
+// equality functions
+template <typename T, typename Hash, typename KeyEqual>
+HashSet<T, Hash, KeyEqual>::HashSet(bool incremental, const Hash& hash,
+                                    const KeyEqual& equal)
+    : hasher_{hash},
+      equal_{equal},
+      hashTable_{new std::vector<Entry>[INITIAL_BUCKETS]},
+      incremental_{incremental},
+      oldTable_{nullptr} {
     // sets initial values
     size_ = 0;
     buckets_ = INITIAL_BUCKETS;
     reallocations_ = 0;
     collisions_ = 0;
     maximal_ = 0;
+    oldBuckets_ = 0;
+    migrated_ = 0;
+}
+
+// range constructor
+template <typename T, typename Hash, typename KeyEqual>
+template <typename InputIt>
+HashSet<T, Hash, KeyEqual>::HashSet(InputIt first, InputIt last,
+                                    const Hash& hash, const KeyEqual& equal)
+    : HashSet(false, hash, equal) {
+    insert(first, last);
 }
 
 // desctructor
-template <typename T>
-HashSet<T>::~HashSet() {
+template <typename T, typename Hash, typename KeyEqual>
+HashSet<T, Hash, KeyEqual>::~HashSet() {
     delete[] hashTable_;
+    delete[] oldTable_;
 }
 
 // returns size_ which is the number of elements
-template <typename T>
-size_t HashSet<T>::size() const {
+template <typename T, typename Hash, typename KeyEqual>
+size_t HashSet<T, Hash, KeyEqual>::size() const {
     return size_;
 }
 
 // inserts an element into the hash table
-template <typename T>
-void HashSet<T>::insert(const T& x) {
+template <typename T, typename Hash, typename KeyEqual>
+void HashSet<T, Hash, KeyEqual>::insert(const T& x) {
+    add(x);
+}
+
+// inserts an element, moving it in
+template <typename T, typename Hash, typename KeyEqual>
+void HashSet<T, Hash, KeyEqual>::insert(T&& x) {
+    add(std::move(x));
+}
+
+// makes an element in place and moves it into the table
+template <typename T, typename Hash, typename KeyEqual>
+template <typename... Args>
+void HashSet<T, Hash, KeyEqual>::emplace(Args&&... args) {
+    add(T(std::forward<Args>(args)...));
+}
+
+// does the work for insert and emplace, copying or moving x only if it
+// isn't already there
+template <typename T, typename Hash, typename KeyEqual>
+template <typename U>
+void HashSet<T, Hash, KeyEqual>::add(U&& x) {
     // if the element exists, behavior is undefined. We just return
-    if (exists(x)) {
+    size_t hv = mixHash(hasher_(x));
+    if (contains(x, hv)) {
         return;
     }
+    // keep any move into a bigger table going
+    if (oldTable_ != nullptr) {
+        migrate(MIGRATE_BUCKETS);
+    }
     // If the hash table is too full(determined by our load factor), make
     // a new table using reallocate and increment reallocations
     if (static_cast<double>(size_)/static_cast<double>(buckets_) >= MAX_LOAD) {
         ++reallocations_;
         reallocate();
     }
+    place(Entry{hv, std::forward<U>(x)});
+    ++size_;
+}
+
+// inserts a range of elements, reserving room for them first if the range
+// can be measured
+template <typename T, typename Hash, typename KeyEqual>
+template <typename InputIt>
+void HashSet<T, Hash, KeyEqual>::insert(InputIt first, InputIt last) {
+    using category = typename std::iterator_traits<InputIt>::iterator_category;
+    if constexpr (std::is_base_of_v<std::forward_iterator_tag, category>) {
+        reserve(size_ + std::distance(first, last));
+    }
+    for (; first != last; ++first) {
+        insert(*first);
+    }
+}
+
+// grows the table to fit n elements in one step
+template <typename T, typename Hash, typename KeyEqual>
+void HashSet<T, Hash, KeyEqual>::reserve(size_t n) {
+    // insert grows the table when it's already at MAX_LOAD, so inserting
+    // the nth element is fine as long as n - 1 elements are below it
+    size_t wanted = buckets_;
+    while (n > 0 && static_cast<double>(n - 1) / wanted >= MAX_LOAD) {
+        wanted *= 2;
+    }
+    if (wanted > buckets_) {
+        // growing an empty table doesn't move anything, so it isn't counted
+        if (size_ != 0) {
+            ++reallocations_;
+        }
+        resize(wanted, false);
+    }
+}
+
+// adds an element to its bucket in hashTable_
+template <typename T, typename Hash, typename KeyEqual>
+void HashSet<T, Hash, KeyEqual>::place(Entry entry) {
     // initialize indexes and lengths for later
-    size_t hv = myhash(x);
-    size_t index = hv % buckets();
+    size_t index = entry.hash_ & (buckets() - 1);
     size_t length = hashTable_[index].size();
     // increment collisions if you insert into a bucket with an element
     if (length != 0) {
@@ -64,78 +157,128 @@ void HashSet<T>::insert(const T& x) {
     }
     // insert the element and increment bucket length. Increment maximal if
     // it is a new longest bucket.
-    hashTable_[index].push_back(x);
+    hashTable_[index].push_back(std::move(entry));
     ++length;
     if (length > maximal_) {
         ++maximal_;
     }
-    ++size_;
 }
 
 // reallocate - doubles the size of the hashtable
-template <typename T>
-void HashSet<T>::reallocate() {
-    // double the number of buckets and reset the other data members
-    buckets_ = buckets_ * 2;
+template <typename T, typename Hash, typename KeyEqual>
+void HashSet<T, Hash, KeyEqual>::reallocate() {
+    resize(buckets_ * 2, incremental_);
+}
+
+// starts moving the elements into a bigger table
+template <typename T, typename Hash, typename KeyEqual>
+void HashSet<T, Hash, KeyEqual>::resize(size_t newBuckets, bool incremental) {
+    // finish off any earlier incremental move first
+    if (oldTable_ != nullptr) {
+        migrate(oldBuckets_);
+    }
+    // change the number of buckets and reset the statistics, which are
+    // recounted as elements go into the new table
+    oldTable_ = hashTable_;
+    oldBuckets_ = buckets_;
+    migrated_ = 0;
+    buckets_ = newBuckets;
     collisions_ = 0;
-    size_ = 0;
     maximal_ = 0;
-    // create a copy of the original hash table
-    auto tempTable = hashTable_;
-    // create a new hash table
-    hashTable_ = new std::vector<T>[buckets_];
-    // insert all the elements into the new hashtable,
-    // thus also updating the data members
-    for (size_t i = 0; i < buckets_ / 2; ++i) {
-        for (size_t j = 0; j < tempTable[i].size(); ++j) {
-            insert(tempTable[i][j]);
+    hashTable_ = new std::vector<Entry>[buckets_];
+    // the elements are already known to be different, so they can be placed
+    // without checking whether they exist, and their hashes are stored
+    if (!incremental) {
+        migrate(oldBuckets_);
+    }
+}
+
+// moves buckets from the old table, in order, and frees the old table once
+// it's empty
+template <typename T, typename Hash, typename KeyEqual>
+void HashSet<T, Hash, KeyEqual>::migrate(size_t count) {
+    for (; count > 0 && migrated_ < oldBuckets_; --count, ++migrated_) {
+        for (Entry& entry : oldTable_[migrated_]) {
+            place(std::move(entry));
         }
+        // free the bucket now, rather than all of them at the end
+        std::vector<Entry>().swap(oldTable_[migrated_]);
+    }
+    if (migrated_ == oldBuckets_) {
+        delete[] oldTable_;
+        oldTable_ = nullptr;
+        oldBuckets_ = 0;
     }
 }
 
 
 // check if the element is already in the hash table
-template <typename T>
-bool HashSet<T>::exists(const T& x) const {
-    // hash the element
-    size_t hv = myhash(x);
-    size_t index = hv % buckets();
+template <typename T, typename Hash, typename KeyEqual>
+bool HashSet<T, Hash, KeyEqual>::exists(const T& x) const {
+    return contains(x, mixHash(hasher_(x)));
+}
+
+// check for a key of some other type, which hashes and compares the same
+// way as the equivalent T
+template <typename T, typename Hash, typename KeyEqual>
+template <typename K, typename H, typename E, typename, typename>
+bool HashSet<T, Hash, KeyEqual>::exists(const K& key) const {
+    return contains(key, mixHash(hasher_(key)));
+}
+
+// looks for key in its bucket, only comparing elements with the same hash
+template <typename T, typename Hash, typename KeyEqual>
+template <typename K>
+bool HashSet<T, Hash, KeyEqual>::contains(const K& key, size_t hv) const {
+    size_t index = hv & (buckets() - 1);
     // check to see if that element is in the table
-    for (size_t j = 0; j < hashTable_[index].size(); ++j) {
-        if (x == hashTable_[index][j]) {
+    for (const Entry& entry : hashTable_[index]) {
+        if (entry.hash_ == hv && equal_(key, entry.value_)) {
             return true;
         }
     }
+    // during an incremental move, it might not have been moved yet
+    if (oldTable_ != nullptr) {
+        size_t oldIndex = hv & (oldBuckets_ - 1);
+        if (oldIndex >= migrated_) {
+            for (const Entry& entry : oldTable_[oldIndex]) {
+                if (entry.hash_ == hv && equal_(key, entry.value_)) {
+                    return true;
+                }
+            }
+        }
+    }
     return false;
 }
 
 // return the number of buckets in the table
-template <typename T>
-size_t HashSet<T>::buckets() const {
+template <typename T, typename Hash, typename KeyEqual>
+size_t HashSet<T, Hash, KeyEqual>::buckets() const {
     return buckets_;
 }
 
 // return the the of times the hashtable has been resized
-template <typename T>
-size_t HashSet<T>::reallocations() const {
+template <typename T, typename Hash, typename KeyEqual>
+size_t HashSet<T, Hash, KeyEqual>::reallocations() const {
     return reallocations_;
 }
 
 // return the recorded number of collisions
-template <typename T>
-size_t HashSet<T>::collisions() const {
+template <typename T, typename Hash, typename KeyEqual>
+size_t HashSet<T, Hash, KeyEqual>::collisions() const {
     return collisions_;
 }
 
 // return the legnth of the largest chain
-template <typename T>
-size_t HashSet<T>::maximal() const {
+template <typename T, typename Hash, typename KeyEqual>
+size_t HashSet<T, Hash, KeyEqual>::maximal() const {
     return maximal_;
 }
 
 // displays the statistics of the hash table
-template <typename T>
-std::ostream& HashSet<T>::showStatistics(std::ostream& out) const {
+template <typename T, typename Hash, typename KeyEqual>
+std::ostream& HashSet<T, Hash, KeyEqual>::showStatistics(
+    std::ostream& out) const {
     out << "Statistics:" << std::endl;
     out << "             Size: " << size() << std::endl;
     out << "          Buckets: " << buckets() << std::endl;
@@ -26,15 +26,35 @@
 // this hash table.
 
 
+#include <functional>
 #include <iostream>
 #include <vector>
 
-template <typename T>
+#include "hash-functors.hpp"
+#include "hash-mixing.hpp"
+
+// Hash is a function object that turns a T (or, for transparent lookup,
+// some other key type) into a size_t; by default it calls myhash. KeyEqual
+// is a function object that says whether two keys are equal.
+template <typename T, typename Hash = MyHash,
+          typename KeyEqual = std::equal_to<T>>
 class HashSet{
  public:
     // Default Constructor and destructor
     HashSet();
     ~HashSet();
+
+    // If incremental is true, growing the table doesn't move every element
+    // at once. Instead the old table is kept, and each insert moves a couple
+    // of its buckets into the new table, so no single insert pays for
+    // rehashing everything. Lookups check both tables until the move is done.
+    explicit HashSet(bool incremental, const Hash& hash = Hash(),
+                     const KeyEqual& equal = KeyEqual());
+
+    // makes a set holding the elements from first to last
+    template <typename InputIt>
+    HashSet(InputIt first, InputIt last, const Hash& hash = Hash(),
+            const KeyEqual& equal = KeyEqual());
     // No assignment operator or copy constructor
     HashSet(const HashSet&) = delete;
     HashSet operator=(const HashSet&) = delete;
@@ -46,12 +66,40 @@ class HashSet{
     // has already been inserted
     void insert(const T&);
 
-    // resizes the hashtable
+    // inserts an element into the hash table, moving it in rather than
+    // copying it
+    void insert(T&& x);
+
+    // makes an element from args and moves it into the hash table
+    template <typename... Args>
+    void emplace(Args&&... args);
+
+    // inserts the elements from first to last. If the range can be measured
+    // without using it up (i.e., first is a forward iterator), makes room
+    // for all of it first
+    template <typename InputIt>
+    void insert(InputIt first, InputIt last);
+
+    // makes the table big enough that it won't need to grow until it holds
+    // more than n elements
+    void reserve(size_t n);
+
+    // resizes the hashtable (in incremental mode, starts moving elements
+    // into a bigger table, after finishing any move already under way)
     void reallocate();
 
     // returns true if the element is present in the hash table
     bool exists(const T&) const;
 
+    // looks up any key that Hash and KeyEqual can handle (e.g., a
+    // std::string_view or const char* in a set of std::string) without
+    // making a T from it. Only available when both are transparent (have an
+    // is_transparent member type), as for std::unordered_set.
+    template <typename K, typename H = Hash, typename E = KeyEqual,
+              typename = typename H::is_transparent,
+              typename = typename E::is_transparent>
+    bool exists(const K& key) const;
+
     // returns the number of buckets
     size_t buckets() const;
 
@@ -69,15 +117,51 @@ class HashSet{
 
  private:
     // private variables
-    static const size_t INITIAL_BUCKETS = 10;
+    // the number of buckets is always a power of two, so the bucket for
+    // a (mixed) hash value is just its low bits
+    static const size_t INITIAL_BUCKETS = 16;
+    static const size_t MIGRATE_BUCKETS = 2;  // old buckets moved per insert
     const double MAX_LOAD = 0.5;
 
+    // An element, along with its full (mixed) hash value, so that growing the
+    // table doesn't need to rehash it and lookups can skip elements whose
+    // hash differs without comparing them
+    struct Entry {
+        size_t hash_;
+        T value_;
+    };
+
+    // inserts x, a const T& or a T&&, unless it's already there
+    template <typename U>
+    void add(U&& x);
+
+    // true if key, whose mixed hash is hv, is in the set
+    template <typename K>
+    bool contains(const K& key, size_t hv) const;
+
+    // puts an element known not to be in the set into hashTable_,
+    // updating the statistics
+    void place(Entry entry);
+
+    // starts moving every element into a new table with newBuckets buckets
+    // (a power of two), finishing at once unless incremental is true
+    void resize(size_t newBuckets, bool incremental);
+
+    // moves up to count buckets from oldTable_ into hashTable_
+    void migrate(size_t count);
+
     size_t size_;           // size of hash table
     size_t buckets_;        // number of buckets
     size_t reallocations_;  // number of resizes
     size_t collisions_;     // number of collsions
     size_t maximal_;        // maximum chain length
-    std::vector<T>* hashTable_;
+    Hash hasher_;
+    KeyEqual equal_;
+    std::vector<Entry>* hashTable_;
+    bool incremental_;              // grow a few buckets at a time?
+    std::vector<Entry>* oldTable_;  // table being emptied, or nullptr
+    size_t oldBuckets_;         // number of buckets in oldTable_
+    size_t migrated_;           // oldTable_ buckets already moved
 };
 #include "hashset-private.hpp"
 
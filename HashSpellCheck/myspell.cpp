@@ -4,17 +4,25 @@
  * Description: Implements a spelling checker
  */
 
+#include <algorithm>
 #include <fstream>
+#include <functional>
 #include <iostream>
+#include <iterator>
+#include <sstream>
 #include <stdexcept>
 #include <string>
+#include <string_view>
+#include <thread>
+#include <utility>
+#include <vector>
 
-// Because of C++ template rules, the string-hashing functions must
-//   be known to the compiler *before* it learns about the HashSet
-//   template class -- even though that means the headers aren't
-//   in alphabetical order.
-#include "stringhash.hpp"
+#include "frozen-hashset.hpp"
 #include "hashset.hpp"
+#include "robinhood-hashset.hpp"
+#include "sharded-hashset.hpp"
+#include "stringhash.hpp"
+#include "swiss-hashset.hpp"
 
 
 using std::cerr;
@@ -23,26 +31,19 @@ using std::endl;
 using std::string;
 
 /**
- * This function processes input from cin and compares against a dictionary
+ * This function checks the words from cin against a dictionary
  *        If the word is not found and has not been seen before, spelling
  *        corrections are printed to standard output.
  *
- * Parameters: dictfile - Name of dictionary file.
- *             debug    - Boolean corresponding to the -d flag
+ *        Dict is the kind of set the dictionary is in, and Set is the kind
+ *        of set to keep the misspelled words in. Both are looked up with
+ *        std::string_views.
+ *
+ * Parameters: dict  - The dictionary.
+ *             debug - Boolean corresponding to the -d flag
  */
-void spellcheck(const string& dictfile, bool debug) {
-  // read in dictionary file
-  string line;
-  std::ifstream dictionary(dictfile);
-  HashSet<string> dict;
-
-  if (dictionary.is_open()) {
-    while (getline(dictionary, line)) {
-      dict.insert(line);
-    }
-    dictionary.close();
-  }
-
+template <typename Set, typename Dict>
+void check(const Dict& dict, bool debug) {
   // if debug, showStatistics
   if (debug) {
     dict.showStatistics(cerr);
@@ -51,31 +52,35 @@ void spellcheck(const string& dictfile, bool debug) {
   const char letters[] = {'a', 'b', 'c', 'd', 'e', 'f', 'g', 'h', 'i', 'j',
     'k', 'l', 'm', 'n', 'o', 'p', 'q', 'r', 's', 't', 'u', 'v', 'w', 'x', 'y',
     'z'};
-  HashSet<string> misspelledWords;
-
-  std::string word;
-  while (std::cin >> word) {
-    // process the word
+  Set misspelledWords;
+
+  std::string token;
+  string temp;
+  while (std::cin >> token) {
+    // process the word: lowercase it, and view it without any leading or
+    // trailing punctuation (no copying)
+    for (size_t i = 0; i < token.length(); ++i) {
+      if (isalpha(token[i])) {
+        token[i] = tolower(token[i]);
+      }
+    }
+    std::string_view word = token;
     if (!isalpha(word.front())) {
-      word.erase(0, 1);
+      word.remove_prefix(1);
     }
-    if (!isalpha(word.back())) {
-      word.pop_back();
-    }
-    for (size_t i = 0; i < word.length(); ++i) {
-      if (isalpha(word[i])) {
-        word[i] = tolower(word[i]);
-      }
+    if (!word.empty() && !isalpha(word.back())) {
+      word.remove_suffix(1);
     }
     // check if word is in dictionary
-    if (!dict.exists(word) && !misspelledWords.exists(word)
-      && word.compare("") != 0) {
-      misspelledWords.insert(word);
+    if (!word.empty() && !dict.exists(word) &&
+        !misspelledWords.exists(word)) {
+      misspelledWords.insert(string{word});
       cout << word << ": ";
 
-      // then, generate set of permutations of word that are in the dictionary
+      // then, generate set of permutations of word that are in the
+      // dictionary, reusing one string for all of them
+      temp = word;
       for (size_t j = 0; j < word.length(); ++j) {
-        string temp = word;
         for (size_t i = 0; i < 26; ++i) {
           temp[j] = letters[i];
           if (dict.exists(temp)) {
@@ -83,37 +88,163 @@ void spellcheck(const string& dictfile, bool debug) {
             cout << temp << " ";
           }
         }
+        temp[j] = word[j];
       }
       cout << endl;
     }
   }
 }
 
+/**
+ * This function loads a dictionary file into a set, one word per line, and
+ *        then runs the spelling checker.
+ *
+ *        Set is the kind of set of strings to use, chosen with the -t flag.
+ *        It hashes with StringHash and compares with std::equal_to<>, so
+ *        words can be looked up as std::string_views.
+ *
+ * Parameters: dictfile - Name of dictionary file.
+ *             debug    - Boolean corresponding to the -d flag
+ */
+template <typename Set>
+void spellcheck(const string& dictfile, bool debug) {
+  // read in dictionary file
+  string line;
+  std::ifstream dictionary(dictfile);
+  Set dict;
+
+  if (dictionary.is_open()) {
+    // count the words first, so the table is the right size from the start
+    // and never has to grow while loading
+    size_t words = std::count(std::istreambuf_iterator<char>(dictionary),
+                              std::istreambuf_iterator<char>(), '\n');
+    dictionary.clear();
+    dictionary.seekg(0);
+    dict.reserve(words + 1);  // the last line might not end in a newline
+    while (getline(dictionary, line)) {
+      dict.insert(std::move(line));
+    }
+    dictionary.close();
+  }
+
+  check<Set>(dict, debug);
+}
+
+/**
+ * This function builds a FrozenHashSet from a dictionary file, and then
+ *        runs the spelling checker, keeping misspelled words in a HashSet.
+ *
+ * Parameters: dictfile - Name of dictionary file.
+ *             debug    - Boolean corresponding to the -d flag
+ */
+void spellcheckFrozen(const string& dictfile, bool debug) {
+  std::ifstream dictionary(dictfile);
+  FrozenHashSet dict{dictionary};
+  check<HashSet<string, StringHash, std::equal_to<>>>(dict, debug);
+}
+
+/**
+ * This function loads a dictionary file into a ShardedHashSet from several
+ *        threads at once, each inserting the words from its own stretch of
+ *        the file, and then runs the spelling checker.
+ *
+ * Parameters: dictfile - Name of dictionary file.
+ *             debug    - Boolean corresponding to the -d flag
+ */
+void spellcheckSharded(const string& dictfile, bool debug) {
+  using Set = ShardedHashSet<string, StringHash, std::equal_to<>>;
+  Set dict;
+
+  std::ifstream dictionary(dictfile);
+  if (dictionary.is_open()) {
+    std::stringstream contents;
+    contents << dictionary.rdbuf();
+    const string text = contents.str();
+    dict.reserve(std::count(text.begin(), text.end(), '\n') + 1);
+
+    // cut the file into one stretch per thread, each ending after a newline
+    size_t threads = std::max(1u, std::thread::hardware_concurrency());
+    std::vector<size_t> starts{0};
+    for (size_t i = 1; i < threads; ++i) {
+      size_t cut = std::max(starts.back(), text.size() * i / threads);
+      cut = text.find('\n', cut);
+      if (cut == string::npos) {
+        break;
+      }
+      starts.push_back(cut + 1);
+    }
+    starts.push_back(text.size());
+
+    std::vector<std::thread> loaders;
+    for (size_t i = 0; i + 1 < starts.size(); ++i) {
+      loaders.emplace_back([&dict, &text, begin = starts[i],
+                            end = starts[i + 1]] {
+        std::istringstream lines{text.substr(begin, end - begin)};
+        string line;
+        while (getline(lines, line)) {
+          dict.insert(std::move(line));
+        }
+      });
+    }
+    for (std::thread& loader : loaders) {
+      loader.join();
+    }
+  }
+
+  check<HashSet<string, StringHash, std::equal_to<>>>(dict, debug);
+}
+
 // Main function: processes input and runs the spellcheck function
 int main(int argc, const char** argv) {
   bool debug = false;
+  string table = "chained";
 
   // Process command-line options
   --argc;  // Skip past 0th arg (program name)
   ++argv;
 
-  // If the user specified debug mode with the -d flag, turn on debugging
-  if (argc == 2 && *argv == string("-d")) {
-    debug = true;
-    --argc;
-    ++argv;
+  // If the user specified debug mode with the -d flag, turn on debugging;
+  // -t picks the kind of hash table
+  while (argc > 1) {
+    if (*argv == string("-d")) {
+      debug = true;
+      --argc;
+      ++argv;
+    } else if (argc > 2 && *argv == string("-t")) {
+      table = argv[1];
+      argc -= 2;
+      argv += 2;
+    } else {
+      break;
+    }
   }
 
   // For correct usage, there should be just one command-line option left
   // If not, print an error to tell the user how they should use this program
-  if (argc != 1) {
-    cerr << "Usage: ./myspell [-d] dict" << endl;
+  if (argc != 1 ||
+      (table != "chained" && table != "frozen" && table != "robinhood" &&
+       table != "sharded" && table != "swiss")) {
+    cerr << "Usage: ./myspell [-d] "
+         << "[-t chained|frozen|robinhood|sharded|swiss] dict" << endl;
     exit(2);
   }
 
   // Check that spelling! Run spellcheck
   try {
-    spellcheck(argv[0], debug);
+    if (table == "frozen") {
+      spellcheckFrozen(argv[0], debug);
+    } else if (table == "robinhood") {
+      spellcheck<RobinHoodHashSet<string, StringHash, std::equal_to<>>>(
+          argv[0], debug);
+    } else if (table == "sharded") {
+      spellcheckSharded(argv[0], debug);
+    } else if (table == "swiss") {
+      spellcheck<SwissHashSet<string, StringHash, std::equal_to<>>>(
+          argv[0], debug);
+    } else {
+      spellcheck<HashSet<string, StringHash, std::equal_to<>>>(argv[0],
+                                                              debug);
+    }
   } catch (std::runtime_error err) {
     cerr << err.what() << endl;
     return 1;
@@ -23,12 +23,19 @@ size_t myhash(const std::string& str) {
   }
   return hv; 
 }
+#include "frozen-hashset.hpp"
 #include "hashset.hpp"
+#include "robinhood-hashset.hpp"
+#include "sharded-hashset.hpp"
+#include "swiss-hashset.hpp"
 // Explicitly instantiate the entire templated class (normally C++ is lazy
 // and only instantiates the things it needs as it needs them, here we make
 // it do everything.)
 
 template class HashSet<std::string>;
+template class RobinHoodHashSet<std::string>;
+template class ShardedHashSet<std::string>;
+template class SwissHashSet<std::string>;
 
 /*****************************************************
  * Functionality Tests
@@ -37,6 +44,14 @@ template class HashSet<std::string>;
  * ***************************************************/
 
 #include "testing-logger.hpp"
+
+#include <cctype>
+#include <sstream>
+#include <stdexcept>
+#include <string_view>
+#include <thread>
+#include <vector>
+
 // check exist, size, maximal, and insert
 bool ourTest() {
   // Set up the TestingLogger object
@@ -73,6 +88,512 @@ bool ourTest() {
   return log.summarize();
 }
 
+// check that an incrementally growing table never loses track of an
+// element while it's being moved between tables
+bool incrementalTest() {
+  // Set up the TestingLogger object
+  TestingLogger log{"incremental rehash test"};
+
+  HashSet<std::string> eager;
+  HashSet<std::string> cows{true};
+  const size_t COWS = 2000;
+  bool allThere = true;
+  for (size_t i = 0; i < COWS; ++i) {
+    std::string cow = "cow" + std::to_string(i);
+    eager.insert(cow);
+    cows.insert(cow);
+    // every earlier cow, whichever table it's in
+    for (size_t j = 0; j <= i; j += 97) {
+      allThere = allThere && cows.exists("cow" + std::to_string(j));
+    }
+    allThere = allThere && cows.exists(cow) && !cows.exists("bull");
+  }
+  affirm(allThere);
+  affirm(cows.size() == COWS);
+  affirm(cows.buckets() == eager.buckets());
+  affirm(cows.reallocations() == eager.reallocations());
+
+  // inserting again changes nothing
+  cows.insert("cow5");
+  affirm(cows.size() == COWS);
+
+  // Print a summary of the all the affirmations and return true
+  // if they were all successful.
+  return log.summarize();
+}
+
+// check that every kind of table keeps a power-of-two number of buckets,
+// and that mixing keeps chains short even with the weak hash above
+bool powerOfTwoTest() {
+  // Set up the TestingLogger object
+  TestingLogger log{"power of two test"};
+
+  HashSet<std::string> chained;
+  RobinHoodHashSet<std::string> robinHood;
+  SwissHashSet<std::string> swiss;
+  for (size_t i = 0; i < 5000; ++i) {
+    std::string cow = "cow" + std::to_string(i);
+    chained.insert(cow);
+    robinHood.insert(cow);
+    swiss.insert(cow);
+  }
+  auto powerOfTwo = [](size_t n) { return n != 0 && (n & (n - 1)) == 0; };
+  affirm(powerOfTwo(chained.buckets()));
+  affirm(powerOfTwo(robinHood.buckets()));
+  affirm(powerOfTwo(swiss.buckets()));
+  affirm(chained.maximal() <= 8);
+
+  // Print a summary of the all the affirmations and return true
+  // if they were all successful.
+  return log.summarize();
+}
+
+// check that the Robin Hood table finds everything it holds, and nothing
+// else, through several reallocations
+bool robinHoodTest() {
+  // Set up the TestingLogger object
+  TestingLogger log{"robin hood test"};
+
+  RobinHoodHashSet<std::string> cows;
+  affirm(!cows.exists("bessie"));
+
+  const size_t COWS = 1000;
+  for (size_t i = 0; i < COWS; ++i) {
+    cows.insert("cow" + std::to_string(i));
+  }
+  // inserting again changes nothing
+  cows.insert("cow7");
+  affirm(cows.size() == COWS);
+  affirm(cows.reallocations() > 0);
+  affirm(cows.buckets() >= COWS);
+
+  bool allThere = true;
+  bool noExtras = true;
+  for (size_t i = 0; i < COWS; ++i) {
+    allThere = allThere && cows.exists("cow" + std::to_string(i));
+    noExtras = noExtras && !cows.exists("bull" + std::to_string(i));
+  }
+  affirm(allThere);
+  affirm(noExtras);
+  affirm(cows.maximal() >= 1);
+
+  // Print a summary of the all the affirmations and return true
+  // if they were all successful.
+  return log.summarize();
+}
+
+// check that the Swiss table finds everything it holds, and nothing else,
+// including words that share a fingerprint
+bool swissTest() {
+  // Set up the TestingLogger object
+  TestingLogger log{"swiss table test"};
+
+  SwissHashSet<std::string> cows;
+  affirm(!cows.exists("bessie"));
+  affirm(!cows.exists(""));
+
+  const size_t COWS = 1000;
+  for (size_t i = 0; i < COWS; ++i) {
+    cows.insert("cow" + std::to_string(i));
+  }
+  cows.insert("cow7");
+  affirm(cows.size() == COWS);
+  affirm(cows.reallocations() > 0);
+  affirm(cows.buckets() % 16 == 0);
+
+  bool allThere = true;
+  bool noExtras = true;
+  for (size_t i = 0; i < COWS; ++i) {
+    allThere = allThere && cows.exists("cow" + std::to_string(i));
+    noExtras = noExtras && !cows.exists("bull" + std::to_string(i));
+  }
+  affirm(allThere);
+  affirm(noExtras);
+
+  // Only 128 fingerprints, so with 1000 cows many must share one
+  affirm(!cows.exists("cow1000"));
+  cows.insert("");
+  affirm(cows.exists(""));
+
+  // Print a summary of the all the affirmations and return true
+  // if they were all successful.
+  return log.summarize();
+}
+
+/// Transparent hash for strings, viewed without copying
+struct ViewHash {
+  using is_transparent = void;
+  size_t operator()(std::string_view str) const {
+    size_t hv = 0;
+    for (unsigned char c : str) {
+      hv = hv * HASH_MULTIPLIER + c;
+    }
+    return hv;
+  }
+};
+
+/// Case-insensitive hash and equality, to check per-instance functions
+size_t foldedHash(const std::string& str) {
+  std::string folded = str;
+  for (char& c : folded) {
+    c = tolower(c);
+  }
+  return myhash(folded);
+}
+
+struct FoldedEqual {
+  bool operator()(const std::string& lhs, const std::string& rhs) const {
+    if (lhs.size() != rhs.size()) {
+      return false;
+    }
+    for (size_t i = 0; i < lhs.size(); ++i) {
+      if (tolower(lhs[i]) != tolower(rhs[i])) {
+        return false;
+      }
+    }
+    return true;
+  }
+};
+
+// check looking up string_views and literals, and passing in hash and
+// equality functions
+bool functorTest() {
+  // Set up the TestingLogger object
+  TestingLogger log{"functor test"};
+
+  HashSet<std::string, ViewHash, std::equal_to<>> chained;
+  RobinHoodHashSet<std::string, ViewHash, std::equal_to<>> robinHood;
+  SwissHashSet<std::string, ViewHash, std::equal_to<>> swiss;
+  for (const char* cow : {"bessie", "mabel", "daisy"}) {
+    chained.insert(cow);
+    robinHood.insert(cow);
+    swiss.insert(cow);
+  }
+  std::string_view herd = "mabel and daisy";
+  affirm(chained.exists("bessie"));
+  affirm(chained.exists(herd.substr(0, 5)));
+  affirm(!chained.exists(herd.substr(0, 4)));
+  affirm(robinHood.exists("daisy"));
+  affirm(robinHood.exists(herd.substr(10)));
+  affirm(!robinHood.exists(herd));
+  affirm(swiss.exists("mabel"));
+  affirm(swiss.exists(herd.substr(10)));
+  affirm(!swiss.exists("Mabel"));
+
+  using FoldedSet =
+      HashSet<std::string, size_t (*)(const std::string&), FoldedEqual>;
+  FoldedSet folded{false, foldedHash};
+  folded.insert("Bessie");
+  folded.insert("BESSIE");
+  affirm(folded.size() == 1);
+  affirm(folded.exists("bEsSiE"));
+  affirm(!folded.exists("Bess"));
+
+  // Print a summary of the all the affirmations and return true
+  // if they were all successful.
+  return log.summarize();
+}
+
+// check that reserve and range inserts size the table once
+template <typename Set>
+bool reserveTest(const std::string& name) {
+  // Set up the TestingLogger object
+  TestingLogger log{name + " reserve test"};
+
+  const size_t COWS = 1000;
+  std::vector<std::string> names;
+  for (size_t i = 0; i < COWS; ++i) {
+    names.push_back("cow" + std::to_string(i));
+  }
+
+  // reserving room means no reallocation while filling it up
+  Set reserved;
+  reserved.reserve(COWS);
+  size_t buckets = reserved.buckets();
+  for (const std::string& cow : names) {
+    reserved.insert(cow);
+  }
+  affirm(reserved.size() == COWS);
+  affirm(reserved.reallocations() == 0);
+  affirm(reserved.buckets() == buckets);
+
+  // reserving less than there's room for does nothing
+  reserved.reserve(10);
+  affirm(reserved.buckets() == buckets);
+
+  // so does building from a vector, even with a duplicate in it
+  names.push_back("cow7");
+  Set built{names.begin(), names.end()};
+  affirm(built.size() == COWS);
+  affirm(built.reallocations() == 0);
+  bool allThere = true;
+  for (size_t i = 0; i < COWS; ++i) {
+    allThere = allThere && built.exists(names[i]);
+  }
+  affirm(allThere);
+  affirm(!built.exists("cow1000"));
+
+  // an input stream can't be measured first, but can still be inserted
+  std::istringstream herd{"bessie mooody paco cow7"};
+  built.insert(std::istream_iterator<std::string>(herd),
+               std::istream_iterator<std::string>());
+  affirm(built.size() == COWS + 3);
+  affirm(built.exists("mooody"));
+
+  // reserving in a full table grows it once, keeping everything
+  size_t before = built.reallocations();
+  built.reserve(4 * COWS);
+  affirm(built.reallocations() == before + 1);
+  affirm(built.buckets() >= 4 * COWS);
+  built.insert(names.begin(), names.end());
+  affirm(built.size() == COWS + 3);
+  affirm(built.exists("cow999"));
+  affirm(built.exists("paco"));
+
+  // Print a summary of the all the affirmations and return true
+  // if they were all successful.
+  return log.summarize();
+}
+
+/// A string that counts how many times it's copied
+struct Tracked {
+  static size_t copies;
+  std::string name_;
+
+  Tracked() = default;
+  explicit Tracked(std::string name) : name_{std::move(name)} {
+  }
+  Tracked(size_t count, char c) : name_(count, c) {
+  }
+  Tracked(const Tracked& other) : name_{other.name_} {
+    ++copies;
+  }
+  Tracked(Tracked&&) = default;
+  Tracked& operator=(const Tracked& other) {
+    name_ = other.name_;
+    ++copies;
+    return *this;
+  }
+  Tracked& operator=(Tracked&&) = default;
+
+  bool operator==(const Tracked& other) const {
+    return name_ == other.name_;
+  }
+};
+
+size_t Tracked::copies = 0;
+
+/// Hashes a Tracked, counting how many times it's called
+struct TrackedHash {
+  static size_t calls;
+
+  size_t operator()(const Tracked& tracked) const {
+    ++calls;
+    return myhash(tracked.name_);
+  }
+};
+
+size_t TrackedHash::calls = 0;
+
+using ChainedHerd = HashSet<Tracked, TrackedHash>;
+using RobinHoodHerd = RobinHoodHashSet<Tracked, TrackedHash>;
+using SwissHerd = SwissHashSet<Tracked, TrackedHash>;
+
+// check that moving elements in, emplacing them, and growing the table
+// doesn't copy them
+template <typename Set>
+bool moveTest(const std::string& name) {
+  // Set up the TestingLogger object
+  TestingLogger log{name + " move test"};
+
+  Tracked::copies = 0;
+  Set herd;
+  const size_t COWS = 1000;
+  for (size_t i = 0; i < COWS; ++i) {
+    herd.insert(Tracked{"cow" + std::to_string(i)});
+  }
+  herd.emplace("bessie");
+  herd.emplace(100, 'm');
+  affirm(herd.size() == COWS + 2);
+  affirm(herd.reallocations() > 0);
+  affirm(Tracked::copies == 0);
+  affirm(herd.exists(Tracked{"cow999"}));
+  affirm(herd.exists(Tracked{"bessie"}));
+  affirm(herd.exists(Tracked(100, 'm')));
+
+  // inserting a copy copies once, and not at all if it's already there
+  Tracked paco{"paco"};
+  herd.insert(paco);
+  affirm(Tracked::copies == 1);
+  herd.insert(paco);
+  herd.insert(Tracked{"cow7"});
+  affirm(Tracked::copies == 1);
+  affirm(herd.size() == COWS + 3);
+  affirm(paco.name_ == "paco");
+
+  // Print a summary of the all the affirmations and return true
+  // if they were all successful.
+  return log.summarize();
+}
+
+// check that inserting hashes each element once, however many times the
+// table grows, and that looking up hashes the key once
+template <typename Set>
+bool hashOnceTest(const std::string& name) {
+  // Set up the TestingLogger object
+  TestingLogger log{name + " hash once test"};
+
+  TrackedHash::calls = 0;
+  Set herd;
+  const size_t COWS = 1000;
+  for (size_t i = 0; i < COWS; ++i) {
+    herd.insert(Tracked{"cow" + std::to_string(i)});
+  }
+  affirm(herd.reallocations() > 0);
+  affirm(TrackedHash::calls == COWS);
+
+  herd.insert(Tracked{"cow7"});
+  affirm(TrackedHash::calls == COWS + 1);
+  affirm(herd.exists(Tracked{"cow7"}));
+  affirm(!herd.exists(Tracked{"bull7"}));
+  affirm(TrackedHash::calls == COWS + 3);
+
+  // Print a summary of the all the affirmations and return true
+  // if they were all successful.
+  return log.summarize();
+}
+
+// check that threads can share a set, and that insert_if_absent lets
+// exactly one of them claim each element
+bool shardedTest() {
+  // Set up the TestingLogger object
+  TestingLogger log{"sharded test"};
+
+  ShardedHashSet<std::string> cows{8};
+  affirm(cows.shards() == 8);
+  affirm(!cows.exists("bessie"));
+  affirm(cows.insert_if_absent("bessie"));
+  affirm(!cows.insert_if_absent("bessie"));
+  affirm(cows.exists("bessie"));
+
+  // every thread tries to insert every cow, and counts the ones it got
+  const size_t THREADS = 4;
+  const size_t COWS = 20000;
+  std::vector<size_t> claimed(THREADS, 0);
+  std::vector<int> sawAll(THREADS, true);
+  std::vector<std::thread> threads;
+  for (size_t t = 0; t < THREADS; ++t) {
+    threads.emplace_back([&, t]() {
+      for (size_t i = 0; i < COWS; ++i) {
+        // each thread starts somewhere different to get more contention
+        std::string cow = "cow" + std::to_string((i + t * COWS / THREADS)
+                                                 % COWS);
+        if (cows.insert_if_absent(cow)) {
+          ++claimed[t];
+        }
+        sawAll[t] = sawAll[t] && cows.exists(cow);
+      }
+    });
+  }
+  for (std::thread& thread : threads) {
+    thread.join();
+  }
+
+  size_t total = 0;
+  for (size_t t = 0; t < THREADS; ++t) {
+    total += claimed[t];
+    affirm(sawAll[t]);
+  }
+  affirm(total == COWS);
+  affirm(cows.size() == COWS + 1);
+  affirm(cows.reallocations() > 0);
+  affirm(!cows.exists("cow" + std::to_string(COWS)));
+
+  // reserving a fresh set means its shards don't have to grow
+  ShardedHashSet<std::string> herd;
+  herd.reserve(COWS);
+  for (size_t i = 0; i < COWS; ++i) {
+    herd.insert("cow" + std::to_string(i));
+  }
+  affirm(herd.size() == COWS);
+  affirm(herd.reallocations() == 0);
+
+  // Print a summary of the all the affirmations and return true
+  // if they were all successful.
+  return log.summarize();
+}
+
+// check that a frozen set finds exactly the words it was built from
+bool frozenTest() {
+  // Set up the TestingLogger object
+  TestingLogger log{"frozen test"};
+
+  FrozenHashSet nobody;
+  affirm(nobody.size() == 0);
+  affirm(!nobody.exists("bessie"));
+  affirm(!nobody.exists(""));
+
+  const size_t COWS = 5000;
+  std::vector<std::string> names;
+  for (size_t i = 0; i < COWS; ++i) {
+    names.push_back("cow" + std::to_string(i));
+  }
+  names.push_back("cow7");
+  names.push_back("");
+  FrozenHashSet cows{names.begin(), names.end()};
+  affirm(cows.size() == COWS + 1);
+  affirm(cows.buckets() < cows.size());
+  affirm(cows.maximal() >= 1);
+
+  bool allThere = true;
+  bool noExtras = true;
+  for (size_t i = 0; i < COWS; ++i) {
+    allThere = allThere && cows.exists("cow" + std::to_string(i));
+    noExtras = noExtras && !cows.exists("bull" + std::to_string(i));
+  }
+  affirm(allThere);
+  affirm(noExtras);
+  affirm(cows.exists(""));
+  affirm(!cows.exists("cow"));
+  affirm(!cows.exists("cow50000"));
+  affirm(cows.exists(std::string_view{"cow123 and more"}.substr(0, 6)));
+
+  // words only take up their own characters, plus about two bytes each of
+  // tables
+  size_t characters = 0;
+  for (size_t i = 0; i < COWS; ++i) {
+    characters += names[i].size();
+  }
+  affirm(cows.slots() > COWS && cows.slots() < COWS + COWS / 16);
+  affirm(cows.bytes() < characters + 2 * cows.size());
+
+  // words that won't fit a one-byte length are turned away
+  bool tooLong = false;
+  try {
+    FrozenHashSet longWords{std::vector<std::string>{std::string(256, 'm')}};
+  } catch (const std::length_error&) {
+    tooLong = true;
+  }
+  affirm(tooLong);
+  FrozenHashSet longest{std::vector<std::string>{std::string(255, 'm'), "m"}};
+  affirm(longest.exists(std::string(255, 'm')));
+  affirm(longest.exists("m"));
+  affirm(!longest.exists(std::string(254, 'm')));
+
+  // one word per line, as in a dictionary file
+  std::istringstream dictionary{"moo\nbessie\nmooody\npaco\nmoo\n"};
+  FrozenHashSet herd{dictionary};
+  affirm(herd.size() == 4);
+  affirm(herd.exists("bessie"));
+  affirm(herd.exists("paco"));
+  affirm(!herd.exists("pac"));
+  affirm(!herd.exists("mooo"));
+
+  // Print a summary of the all the affirmations and return true
+  // if they were all successful.
+  return log.summarize();
+}
+
 /****************************
  * Boilerplate main function
  * **************************/
@@ -95,6 +616,22 @@ int main() {
 
   // Add calls to your tests here...
   affirm(ourTest());
+  affirm(incrementalTest());
+  affirm(powerOfTwoTest());
+  affirm(robinHoodTest());
+  affirm(swissTest());
+  affirm(functorTest());
+  affirm(reserveTest<HashSet<std::string>>("chained"));
+  affirm(reserveTest<RobinHoodHashSet<std::string>>("robin hood"));
+  affirm(reserveTest<SwissHashSet<std::string>>("swiss"));
+  affirm(moveTest<ChainedHerd>("chained"));
+  affirm(moveTest<RobinHoodHerd>("robin hood"));
+  affirm(moveTest<SwissHerd>("swiss"));
+  affirm(hashOnceTest<ChainedHerd>("chained"));
+  affirm(hashOnceTest<RobinHoodHerd>("robin hood"));
+  affirm(hashOnceTest<SwissHerd>("swiss"));
+  affirm(shardedTest());
+  affirm(frozenTest());
 
   if (alltests.summarize(true)) {
     return 0;  // Error code of 0 == Success!
@@ -0,0 +1,250 @@
+/**
+ * \file robinhood-hashset-private.hpp
+ *
+ * \brief Implements RobinHoodHashSet<T>, an open-addressing hash-table
+ *        class template
+ *
+ * \remark There is no include-guard for this file, because it is
+ *         only #included by robinhood-hashset.hpp, inside
+ *         robinhood-hashset.hpp's own include guard.
+ */
+
+#include "robinhood-hashset.hpp"
+#include <functional>
+#include <iostream>
+#include <iterator>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+// default constructor
+template <typename T, typename Hash, typename KeyEqual>
+RobinHoodHashSet<T, Hash, KeyEqual>::RobinHoodHashSet()
+    : RobinHoodHashSet(Hash()) {
+    // Nothing else to do.
+}
+
+// constructor choosing the hash and equality functions
+template <typename T, typename Hash, typename KeyEqual>
+RobinHoodHashSet<T, Hash, KeyEqual>::RobinHoodHashSet(const Hash& hash,
+                                                      const KeyEqual& equal)
+    : hasher_{hash}, equal_{equal}, table_(INITIAL_BUCKETS) {
+    // sets initial values
+    size_ = 0;
+    reallocations_ = 0;
+    collisions_ = 0;
+    maximal_ = 0;
+}
+
+// range constructor
+template <typename T, typename Hash, typename KeyEqual>
+template <typename InputIt>
+RobinHoodHashSet<T, Hash, KeyEqual>::RobinHoodHashSet(InputIt first,
+                                                      InputIt last,
+                                                      const Hash& hash,
+                                                      const KeyEqual& equal)
+    : RobinHoodHashSet(hash, equal) {
+    insert(first, last);
+}
+
+// returns size_ which is the number of elements
+template <typename T, typename Hash, typename KeyEqual>
+size_t RobinHoodHashSet<T, Hash, KeyEqual>::size() const {
+    return size_;
+}
+
+// inserts an element into the hash table
+template <typename T, typename Hash, typename KeyEqual>
+void RobinHoodHashSet<T, Hash, KeyEqual>::insert(const T& x) {
+    add(x);
+}
+
+// inserts an element, moving it in
+template <typename T, typename Hash, typename KeyEqual>
+void RobinHoodHashSet<T, Hash, KeyEqual>::insert(T&& x) {
+    add(std::move(x));
+}
+
+// makes an element in place and moves it into the table
+template <typename T, typename Hash, typename KeyEqual>
+template <typename... Args>
+void RobinHoodHashSet<T, Hash, KeyEqual>::emplace(Args&&... args) {
+    add(T(std::forward<Args>(args)...));
+}
+
+// does the work for insert and emplace, copying or moving x only if it
+// isn't already there
+template <typename T, typename Hash, typename KeyEqual>
+template <typename U>
+void RobinHoodHashSet<T, Hash, KeyEqual>::add(U&& x) {
+    size_t hv = mixHash(hasher_(x));
+    if (lookup(x, hv)) {
+        return;
+    }
+    // grow before the table gets so full that probe sequences get long
+    if (static_cast<double>(size_ + 1) / table_.size() > MAX_LOAD) {
+        ++reallocations_;
+        reallocate();
+    }
+    if (table_[home(hv)].probe_ != 0) {
+        ++collisions_;
+    }
+    place(Slot{std::forward<U>(x), 1, hv});
+    ++size_;
+}
+
+// inserts a range of elements, reserving room for them first if the range
+// can be measured
+template <typename T, typename Hash, typename KeyEqual>
+template <typename InputIt>
+void RobinHoodHashSet<T, Hash, KeyEqual>::insert(InputIt first,
+                                                 InputIt last) {
+    using category = typename std::iterator_traits<InputIt>::iterator_category;
+    if constexpr (std::is_base_of_v<std::forward_iterator_tag, category>) {
+        reserve(size_ + std::distance(first, last));
+    }
+    for (; first != last; ++first) {
+        insert(*first);
+    }
+}
+
+// grows the table to fit n elements in one step
+template <typename T, typename Hash, typename KeyEqual>
+void RobinHoodHashSet<T, Hash, KeyEqual>::reserve(size_t n) {
+    size_t wanted = table_.size();
+    while (static_cast<double>(n) / wanted > MAX_LOAD) {
+        wanted *= 2;
+    }
+    if (wanted > table_.size()) {
+        // growing an empty table doesn't move anything, so it isn't counted
+        if (size_ != 0) {
+            ++reallocations_;
+        }
+        resize(wanted);
+    }
+}
+
+// the hash is mixed, so masking keeps a good spread of slots
+template <typename T, typename Hash, typename KeyEqual>
+size_t RobinHoodHashSet<T, Hash, KeyEqual>::home(size_t hv) const {
+    return hv & (buckets() - 1);
+}
+
+// walks forward from the element's home slot until it finds an empty slot,
+// swapping the element being placed with any element that is closer to its
+// own home
+template <typename T, typename Hash, typename KeyEqual>
+void RobinHoodHashSet<T, Hash, KeyEqual>::place(Slot incoming) {
+    size_t index = home(incoming.hash_);
+    while (true) {
+        Slot& slot = table_[index];
+        if (slot.probe_ == 0) {
+            if (incoming.probe_ > maximal_) {
+                maximal_ = incoming.probe_;
+            }
+            slot = std::move(incoming);
+            return;
+        }
+        if (slot.probe_ < incoming.probe_) {
+            if (incoming.probe_ > maximal_) {
+                maximal_ = incoming.probe_;
+            }
+            std::swap(slot, incoming);
+        }
+        index = (index + 1) & (buckets() - 1);
+        ++incoming.probe_;
+    }
+}
+
+// reallocate - doubles the size of the hashtable
+template <typename T, typename Hash, typename KeyEqual>
+void RobinHoodHashSet<T, Hash, KeyEqual>::reallocate() {
+    resize(table_.size() * 2);
+}
+
+// moves every element into a new table, using the hashes stored with them
+template <typename T, typename Hash, typename KeyEqual>
+void RobinHoodHashSet<T, Hash, KeyEqual>::resize(size_t slots) {
+    std::vector<Slot> oldTable(slots);
+    std::swap(oldTable, table_);
+    collisions_ = 0;
+    maximal_ = 0;
+    // elements already in the table are all different, so they can be
+    // placed without checking whether they exist
+    for (Slot& slot : oldTable) {
+        if (slot.probe_ != 0) {
+            if (table_[home(slot.hash_)].probe_ != 0) {
+                ++collisions_;
+            }
+            slot.probe_ = 1;
+            place(std::move(slot));
+        }
+    }
+}
+
+// check if the element is already in the hash table
+template <typename T, typename Hash, typename KeyEqual>
+bool RobinHoodHashSet<T, Hash, KeyEqual>::exists(const T& x) const {
+    return lookup(x, mixHash(hasher_(x)));
+}
+
+// check for a key of some other type
+template <typename T, typename Hash, typename KeyEqual>
+template <typename K, typename H, typename E, typename, typename>
+bool RobinHoodHashSet<T, Hash, KeyEqual>::exists(const K& key) const {
+    return lookup(key, mixHash(hasher_(key)));
+}
+
+// walks forward from key's home slot, only comparing elements with the
+// same hash; an element closer to its home than key would be means key
+// isn't there
+template <typename T, typename Hash, typename KeyEqual>
+template <typename K>
+bool RobinHoodHashSet<T, Hash, KeyEqual>::lookup(const K& key,
+                                                 size_t hv) const {
+    size_t index = home(hv);
+    for (size_t probe = 1; table_[index].probe_ >= probe; ++probe) {
+        if (table_[index].hash_ == hv && equal_(key, table_[index].value_)) {
+            return true;
+        }
+        index = (index + 1) & (buckets() - 1);
+    }
+    return false;
+}
+
+// return the number of slots in the table
+template <typename T, typename Hash, typename KeyEqual>
+size_t RobinHoodHashSet<T, Hash, KeyEqual>::buckets() const {
+    return table_.size();
+}
+
+// return the the of times the hashtable has been resized
+template <typename T, typename Hash, typename KeyEqual>
+size_t RobinHoodHashSet<T, Hash, KeyEqual>::reallocations() const {
+    return reallocations_;
+}
+
+// return the recorded number of collisions
+template <typename T, typename Hash, typename KeyEqual>
+size_t RobinHoodHashSet<T, Hash, KeyEqual>::collisions() const {
+    return collisions_;
+}
+
+// return the longest probe sequence
+template <typename T, typename Hash, typename KeyEqual>
+size_t RobinHoodHashSet<T, Hash, KeyEqual>::maximal() const {
+    return maximal_;
+}
+
+// displays the statistics of the hash table
+template <typename T, typename Hash, typename KeyEqual>
+std::ostream& RobinHoodHashSet<T, Hash, KeyEqual>::showStatistics(
+    std::ostream& out) const {
+    out << "Statistics:" << std::endl;
+    out << "             Size: " << size() << std::endl;
+    out << "          Buckets: " << buckets() << std::endl;
+    out << "    Reallocations: " << reallocations() << std::endl;
+    out << "       Collisions: " << collisions() << std::endl;
+    out << " Max probe length: " << maximal() << std::endl;
+    return out;
+}
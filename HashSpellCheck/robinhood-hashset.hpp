@@ -0,0 +1,153 @@
+/**
+ * \file robinhood-hashset.hpp
+ *
+ * \brief Provides RobinHoodHashSet<T>, a set class template, using an
+ *        open-addressing hash table with Robin Hood displacement
+ */
+
+#ifndef ROBINHOOD_HASHSET_HPP_INCLUDED
+#define ROBINHOOD_HASHSET_HPP_INCLUDED 1
+
+// Like HashSet<T>, the implementation lives in robinhood-hashset-private.hpp,
+// which is included at the bottom of this file.
+//
+// Unlike HashSet<T>, every element lives directly in one array of slots, so
+// there's no per-bucket allocation and no pointer to chase. Colliding
+// elements go in the following slots (linear probing). On insert, an element
+// that is further from its home slot than the one sitting in a slot takes
+// that slot, and the displaced element moves on ("take from the rich, give
+// to the poor"). That keeps every element close to home, and it lets
+// `exists` give up as soon as it reaches an element that is closer to home
+// than the one it's looking for would be.
+
+#include <functional>
+#include <iostream>
+#include <vector>
+
+#include "hash-functors.hpp"
+#include "hash-mixing.hpp"
+
+// Hash is a function object that turns a T (or, for transparent lookup,
+// some other key type) into a size_t; by default it calls myhash. KeyEqual
+// is a function object that says whether two keys are equal.
+template <typename T, typename Hash = MyHash,
+          typename KeyEqual = std::equal_to<T>>
+class RobinHoodHashSet{
+ public:
+    // Default Constructor and destructor
+    RobinHoodHashSet();
+    explicit RobinHoodHashSet(const Hash& hash,
+                              const KeyEqual& equal = KeyEqual());
+
+    // makes a set holding the elements from first to last
+    template <typename InputIt>
+    RobinHoodHashSet(InputIt first, InputIt last, const Hash& hash = Hash(),
+                     const KeyEqual& equal = KeyEqual());
+    ~RobinHoodHashSet() = default;
+    // No assignment operator or copy constructor
+    RobinHoodHashSet(const RobinHoodHashSet&) = delete;
+    RobinHoodHashSet operator=(const RobinHoodHashSet&) = delete;
+
+    // returns the number of items stored in the table
+    size_t size() const;
+
+    // inserts an element into the hash table. Does nothing if the insertee
+    // has already been inserted
+    void insert(const T&);
+
+    // inserts an element into the hash table, moving it in rather than
+    // copying it
+    void insert(T&& x);
+
+    // makes an element from args and moves it into the hash table
+    template <typename... Args>
+    void emplace(Args&&... args);
+
+    // inserts the elements from first to last. If the range can be measured
+    // without using it up (i.e., first is a forward iterator), makes room
+    // for all of it first
+    template <typename InputIt>
+    void insert(InputIt first, InputIt last);
+
+    // makes the table big enough that it won't need to grow until it holds
+    // more than n elements
+    void reserve(size_t n);
+
+    // resizes the hashtable
+    void reallocate();
+
+    // returns true if the element is present in the hash table
+    bool exists(const T&) const;
+
+    // looks up any key that Hash and KeyEqual can handle (e.g., a
+    // std::string_view or const char* in a set of std::string) without
+    // making a T from it. Only available when both are transparent (have an
+    // is_transparent member type), as for std::unordered_set.
+    template <typename K, typename H = Hash, typename E = KeyEqual,
+              typename = typename H::is_transparent,
+              typename = typename E::is_transparent>
+    bool exists(const K& key) const;
+
+    // returns the number of buckets (slots)
+    size_t buckets() const;
+
+    // returns the number of times the hash table has resized
+    size_t reallocations() const;
+
+    // returns the number of times an insert found its home slot taken
+    size_t collisions() const;
+
+    // returns the longest probe sequence: the most slots an element is
+    // from its home slot, plus one
+    size_t maximal() const;
+
+    // prints all the relevant statistics about the hash table
+    std::ostream& showStatistics(std::ostream& out) const;
+
+ private:
+    // One slot of the table. probe_ is 0 for an empty slot, or one more
+    // than the number of slots the element is from its home slot. hash_ is
+    // the element's full (mixed) hash value, so growing the table doesn't
+    // need to rehash it and lookups can skip elements whose hash differs
+    // without comparing them.
+    struct Slot {
+        T value_;
+        size_t probe_ = 0;
+        size_t hash_ = 0;
+    };
+
+    // private variables
+    // the number of slots is always a power of two
+    static const size_t INITIAL_BUCKETS = 16;
+    const double MAX_LOAD = 0.8;
+
+    // the slot where an element with mixed hash hv belongs, if it's not
+    // taken
+    size_t home(size_t hv) const;
+
+    // true if key, whose mixed hash is hv, is in the set
+    template <typename K>
+    bool lookup(const K& key, size_t hv) const;
+
+    // inserts x, a const T& or a T&&, unless it's already there
+    template <typename U>
+    void add(U&& x);
+
+    // puts an element known not to be in the table into place
+    void place(Slot incoming);
+
+    // moves every element into a new table with the given number of slots
+    // (a power of two)
+    void resize(size_t slots);
+
+    size_t size_;           // number of elements
+    size_t reallocations_;  // number of resizes
+    size_t collisions_;     // number of collsions
+    size_t maximal_;        // longest probe sequence
+    Hash hasher_;
+    KeyEqual equal_;
+    std::vector<Slot> table_;
+};
+#include "robinhood-hashset-private.hpp"
+
+#endif
@@ -0,0 +1,201 @@
+/**
+ * \file sharded-hashset-private.hpp
+ *
+ * \brief Implements ShardedHashSet<T>, a hash-table class template with one
+ *        lock per shard
+ *
+ * \remark There is no include-guard for this file, because it is
+ *         only #included by sharded-hashset.hpp, inside
+ *         sharded-hashset.hpp's own include guard.
+ */
+
+#include "sharded-hashset.hpp"
+#include <algorithm>
+#include <functional>
+#include <iostream>
+#include <memory>
+#include <mutex>
+#include <shared_mutex>
+#include <utility>
+#include <vector>
+
+// shard constructor
+template <typename T, typename Hash, typename KeyEqual>
+ShardedHashSet<T, Hash, KeyEqual>::Shard::Shard(const Hash& hash,
+                                                const KeyEqual& equal)
+    : set_{false, hash, equal} {
+    // Nothing else to do.
+}
+
+// default constructor
+template <typename T, typename Hash, typename KeyEqual>
+ShardedHashSet<T, Hash, KeyEqual>::ShardedHashSet()
+    : ShardedHashSet(DEFAULT_SHARDS) {
+    // Nothing else to do.
+}
+
+// constructor choosing the number of shards, and the hash and equality
+// functions
+template <typename T, typename Hash, typename KeyEqual>
+ShardedHashSet<T, Hash, KeyEqual>::ShardedHashSet(size_t shards,
+                                                  const Hash& hash,
+                                                  const KeyEqual& equal)
+    : hasher_{hash} {
+    size_t count = 1;
+    while (count < shards) {
+        count *= 2;
+    }
+    for (size_t i = 0; i < count; ++i) {
+        shards_.push_back(std::make_unique<Shard>(hash, equal));
+    }
+}
+
+// adds up the sizes of the shards
+template <typename T, typename Hash, typename KeyEqual>
+size_t ShardedHashSet<T, Hash, KeyEqual>::size() const {
+    return total([](const HashSet<T, Hash, KeyEqual>& set) {
+        return set.size();
+    });
+}
+
+// inserts an element into the hash table
+template <typename T, typename Hash, typename KeyEqual>
+void ShardedHashSet<T, Hash, KeyEqual>::insert(const T& x) {
+    add(x);
+}
+
+// inserts an element, moving it in
+template <typename T, typename Hash, typename KeyEqual>
+void ShardedHashSet<T, Hash, KeyEqual>::insert(T&& x) {
+    add(std::move(x));
+}
+
+// inserts an element, saying whether it was new
+template <typename T, typename Hash, typename KeyEqual>
+bool ShardedHashSet<T, Hash, KeyEqual>::insert_if_absent(const T& x) {
+    return add(x);
+}
+
+// inserts an element, moving it in, and says whether it was new
+template <typename T, typename Hash, typename KeyEqual>
+bool ShardedHashSet<T, Hash, KeyEqual>::insert_if_absent(T&& x) {
+    return add(std::move(x));
+}
+
+// checks for the element and inserts it while holding its shard's lock, so
+// no other thread can insert it in between
+template <typename T, typename Hash, typename KeyEqual>
+template <typename U>
+bool ShardedHashSet<T, Hash, KeyEqual>::add(U&& x) {
+    Shard& shard = shardFor(x);
+    std::unique_lock<std::shared_mutex> lock{shard.mutex_};
+    size_t before = shard.set_.size();
+    shard.set_.insert(std::forward<U>(x));
+    return shard.set_.size() != before;
+}
+
+// hashing spreads elements evenly, so each shard gets about the same share,
+// plus some slack because the shares aren't exactly equal
+template <typename T, typename Hash, typename KeyEqual>
+void ShardedHashSet<T, Hash, KeyEqual>::reserve(size_t n) {
+    size_t share = n / shards_.size();
+    share += share / 8;
+    for (const std::unique_ptr<Shard>& shard : shards_) {
+        std::unique_lock<std::shared_mutex> lock{shard->mutex_};
+        shard->set_.reserve(share);
+    }
+}
+
+// picks a shard using the high half of the mixed hash, since the shard's
+// own table picks buckets using the low bits
+template <typename T, typename Hash, typename KeyEqual>
+template <typename K>
+typename ShardedHashSet<T, Hash, KeyEqual>::Shard&
+ShardedHashSet<T, Hash, KeyEqual>::shardFor(const K& key) const {
+    size_t hv = mixHash(hasher_(key));
+    return *shards_[(hv >> (sizeof(size_t) * 4)) & (shards_.size() - 1)];
+}
+
+// check if the element is already in the hash table
+template <typename T, typename Hash, typename KeyEqual>
+bool ShardedHashSet<T, Hash, KeyEqual>::exists(const T& x) const {
+    Shard& shard = shardFor(x);
+    std::shared_lock<std::shared_mutex> lock{shard.mutex_};
+    return shard.set_.exists(x);
+}
+
+// check for a key of some other type
+template <typename T, typename Hash, typename KeyEqual>
+template <typename K, typename H, typename E, typename, typename>
+bool ShardedHashSet<T, Hash, KeyEqual>::exists(const K& key) const {
+    Shard& shard = shardFor(key);
+    std::shared_lock<std::shared_mutex> lock{shard.mutex_};
+    return shard.set_.exists(key);
+}
+
+// locks each shard in turn to read one of its statistics
+template <typename T, typename Hash, typename KeyEqual>
+template <typename Statistic>
+size_t ShardedHashSet<T, Hash, KeyEqual>::total(Statistic statistic) const {
+    size_t sum = 0;
+    for (const std::unique_ptr<Shard>& shard : shards_) {
+        std::shared_lock<std::shared_mutex> lock{shard->mutex_};
+        sum += statistic(shard->set_);
+    }
+    return sum;
+}
+
+// return the number of shards
+template <typename T, typename Hash, typename KeyEqual>
+size_t ShardedHashSet<T, Hash, KeyEqual>::shards() const {
+    return shards_.size();
+}
+
+// return the number of buckets in all the shards
+template <typename T, typename Hash, typename KeyEqual>
+size_t ShardedHashSet<T, Hash, KeyEqual>::buckets() const {
+    return total([](const HashSet<T, Hash, KeyEqual>& set) {
+        return set.buckets();
+    });
+}
+
+// return the the of times the shards have been resized
+template <typename T, typename Hash, typename KeyEqual>
+size_t ShardedHashSet<T, Hash, KeyEqual>::reallocations() const {
+    return total([](const HashSet<T, Hash, KeyEqual>& set) {
+        return set.reallocations();
+    });
+}
+
+// return the recorded number of collisions
+template <typename T, typename Hash, typename KeyEqual>
+size_t ShardedHashSet<T, Hash, KeyEqual>::collisions() const {
+    return total([](const HashSet<T, Hash, KeyEqual>& set) {
+        return set.collisions();
+    });
+}
+
+// return the length of the longest chain in any shard
+template <typename T, typename Hash, typename KeyEqual>
+size_t ShardedHashSet<T, Hash, KeyEqual>::maximal() const {
+    size_t longest = 0;
+    for (const std::unique_ptr<Shard>& shard : shards_) {
+        std::shared_lock<std::shared_mutex> lock{shard->mutex_};
+        longest = std::max(longest, shard->set_.maximal());
+    }
+    return longest;
+}
+
+// displays the statistics of the hash table
+template <typename T, typename Hash, typename KeyEqual>
+std::ostream& ShardedHashSet<T, Hash, KeyEqual>::showStatistics(
+    std::ostream& out) const {
+    out << "Statistics:" << std::endl;
+    out << "             Size: " << size() << std::endl;
+    out << "           Shards: " << shards() << std::endl;
+    out << "          Buckets: " << buckets() << std::endl;
+    out << "    Reallocations: " << reallocations() << std::endl;
+    out << "       Collisions: " << collisions() << std::endl;
+    out << "Max Bucket length: " << maximal() << std::endl;
+    return out;
+}
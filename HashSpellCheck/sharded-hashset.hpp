@@ -0,0 +1,130 @@
+/**
+ * \file sharded-hashset.hpp
+ *
+ * \brief Provides ShardedHashSet<T>, a set class template that many threads
+ *        can use at once
+ */
+
+#ifndef SHARDED_HASHSET_HPP_INCLUDED
+#define SHARDED_HASHSET_HPP_INCLUDED 1
+
+// Like HashSet<T>, the implementation lives in sharded-hashset-private.hpp,
+// which is included at the bottom of this file.
+//
+// None of the other hash sets can be shared between threads: an insert in
+// one thread can reallocate the table while another thread is looking
+// through it. Putting one lock around a whole set would make every thread
+// wait its turn, so instead the elements are split between a number of
+// shards, each an ordinary HashSet with its own lock, and the hash of an
+// element says which shard it belongs in. Threads only wait for each other
+// when they use the same shard at the same time, and even then lookups
+// only take a shared (reader) lock, so they only wait for inserts.
+
+#include <functional>
+#include <iostream>
+#include <memory>
+#include <shared_mutex>
+#include <vector>
+
+#include "hash-functors.hpp"
+#include "hash-mixing.hpp"
+#include "hashset.hpp"
+
+// Hash is a function object that turns a T (or, for transparent lookup,
+// some other key type) into a size_t; by default it calls myhash. KeyEqual
+// is a function object that says whether two keys are equal.
+template <typename T, typename Hash = MyHash,
+          typename KeyEqual = std::equal_to<T>>
+class ShardedHashSet{
+ public:
+    // Default Constructor and destructor
+    ShardedHashSet();
+    // shards is rounded up to a power of two
+    explicit ShardedHashSet(size_t shards, const Hash& hash = Hash(),
+                            const KeyEqual& equal = KeyEqual());
+    ~ShardedHashSet() = default;
+    // No assignment operator or copy constructor
+    ShardedHashSet(const ShardedHashSet&) = delete;
+    ShardedHashSet operator=(const ShardedHashSet&) = delete;
+
+    // All of the member functions below are safe to call from any number
+    // of threads at once.
+
+    // returns the number of items stored in the table. If other threads
+    // are inserting, it may already be out of date.
+    size_t size() const;
+
+    // inserts an element into the hash table. Does nothing if the insertee
+    // has already been inserted
+    void insert(const T& x);
+    void insert(T&& x);
+
+    // inserts an element if it isn't already there, and returns true if it
+    // was inserted. When several threads insert the same element, exactly
+    // one of them gets true.
+    bool insert_if_absent(const T& x);
+    bool insert_if_absent(T&& x);
+
+    // makes each shard big enough for its share of n elements
+    void reserve(size_t n);
+
+    // returns true if the element is present in the hash table
+    bool exists(const T&) const;
+
+    // looks up any key that Hash and KeyEqual can handle without making a
+    // T from it, like HashSet::exists
+    template <typename K, typename H = Hash, typename E = KeyEqual,
+              typename = typename H::is_transparent,
+              typename = typename E::is_transparent>
+    bool exists(const K& key) const;
+
+    // returns the number of shards
+    size_t shards() const;
+
+    // returns the total number of buckets in all the shards
+    size_t buckets() const;
+
+    // returns the total number of times the shards have resized
+    size_t reallocations() const;
+
+    // returns the total number of collisions in all the shards
+    size_t collisions() const;
+
+    // returns the length of the longest chain in any shard
+    size_t maximal() const;
+
+    // prints all the relevant statistics about the hash table
+    std::ostream& showStatistics(std::ostream& out) const;
+
+ private:
+    // One shard and the lock that guards it. Shards are allocated
+    // separately, and each one is aligned to a cache line so that locking
+    // one shard doesn't slow down threads using its neighbours.
+    struct alignas(64) Shard {
+        Shard(const Hash& hash, const KeyEqual& equal);
+
+        mutable std::shared_mutex mutex_;
+        HashSet<T, Hash, KeyEqual> set_;
+    };
+
+    // private variables
+    static const size_t DEFAULT_SHARDS = 64;
+
+    // the shard where key belongs
+    template <typename K>
+    Shard& shardFor(const K& key) const;
+
+    // does the work for insert and insert_if_absent
+    template <typename U>
+    bool add(U&& x);
+
+    // adds up a statistic over all the shards
+    template <typename Statistic>
+    size_t total(Statistic statistic) const;
+
+    Hash hasher_;
+    std::vector<std::unique_ptr<Shard>> shards_;
+};
+#include "sharded-hashset-private.hpp"
+
+#endif
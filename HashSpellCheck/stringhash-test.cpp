@@ -62,7 +62,7 @@ unsigned int countBits(size_t n) {
  *
  */
 void doTests(const char* filename, size_t numBuckets,
-             size_t (*myhash)(const std::string& str)) {
+             size_t (*myhash)(std::string_view str)) {
   // Open provided file
   ifstream inFile(filename);
   if (!inFile) {
@@ -7,7 +7,7 @@
 
 #include "stringhash.hpp"
 
-using std::string;
+using std::string_view;
 
 // Hash Function Gallery
 //
@@ -25,7 +25,7 @@ namespace {
  */
 constexpr unsigned long HASH_MULTIPLIER = 37;
 
-unsigned long hash1(const string& str) {
+unsigned long hash1(string_view str) {
   unsigned long hv = 0;
   for (unsigned char c : str) {
     hv = hv * HASH_MULTIPLIER + c;
@@ -38,7 +38,7 @@ unsigned long hash1(const string& str) {
   * It is a good general hash function and uses the magic, prime constant
   * 6599. This implementation uses bitshifting for efficency.
   */
-  unsigned long hash2(const string& str) {
+  unsigned long hash2(string_view str) {
     unsigned long hash = 0;
 
     for (unsigned char c : str) {
@@ -51,7 +51,7 @@ unsigned long hash1(const string& str) {
   * A hash function by Dan Bernstein that uses bitshifting and the magic 
   * number 33
   */
-  unsigned long hash3(const string& str) {
+  unsigned long hash3(string_view str) {
   unsigned long hash = 5381;
 
   for (unsigned char c : str) {
@@ -61,7 +61,7 @@ unsigned long hash1(const string& str) {
   }
 }  // end of anonymous namespace
 
-size_t myhash(const string& str) {
+size_t myhash(string_view str) {
   // FIXME: Make this code call your favorite of the ones you've defined
   //        above.
   return hash1(str);
@@ -10,24 +10,40 @@
 
 #include <cstddef>
 #include <string>
+#include <string_view>
 
 /**
  * \param str      String to hash.
  * \returns      Hash value of the std::string.
  *
  * \details
- *   This function takes in a std::string and then returns the correct hash
- *   value. The hash function returns an integer that can span the
- *   full range of unsigned ints.
+ *   This function takes in a std::string (or anything that can be viewed as
+ *   one, such as a std::string_view or a string literal) and then returns
+ *   the correct hash value. The hash function returns an integer that can
+ *   span the full range of unsigned ints.
  */
-size_t myhash(const std::string& str);
+size_t myhash(std::string_view str);
+
+/**
+ * \brief Hash function object for the hash sets, using myhash
+ *
+ * \details Transparent: when a set of std::strings uses StringHash along
+ *          with std::equal_to<> it can look up a std::string_view or a
+ *          const char* without first copying it into a std::string. Using
+ *          it also means the set headers can be included in any order.
+ */
+struct StringHash {
+  using is_transparent = void;
+
+  size_t operator()(std::string_view str) const { return myhash(str); }
+};
 
 /**
  * Describes a hash function for the stringhash-test code.
  */
 struct HashFunctionInfo {
   std::string name_;
-  size_t (*func_)(const std::string& str);
+  size_t (*func_)(std::string_view str);
 };
 
 /**
@@ -0,0 +1,272 @@
+/**
+ * \file swiss-hashset-private.hpp
+ *
+ * \brief Implements SwissHashSet<T>, a hash-table class template with
+ *        SIMD fingerprint matching
+ *
+ * \remark There is no include-guard for this file, because it is
+ *         only #included by swiss-hashset.hpp, inside swiss-hashset.hpp's
+ *         own include guard.
+ */
+
+#include "swiss-hashset.hpp"
+#include <cstdint>
+#include <functional>
+#include <iostream>
+#include <iterator>
+#include <type_traits>
+#include <utility>
+#include <vector>
+#ifdef __SSE2__
+#include <emmintrin.h>
+#endif
+
+// default constructor
+template <typename T, typename Hash, typename KeyEqual>
+SwissHashSet<T, Hash, KeyEqual>::SwissHashSet() : SwissHashSet(Hash()) {
+    // Nothing else to do.
+}
+
+// constructor choosing the hash and equality functions
+template <typename T, typename Hash, typename KeyEqual>
+SwissHashSet<T, Hash, KeyEqual>::SwissHashSet(const Hash& hash,
+                                              const KeyEqual& equal)
+    : hasher_{hash},
+      equal_{equal},
+      control_(INITIAL_GROUPS * GROUP_SIZE, EMPTY),
+      slots_(INITIAL_GROUPS * GROUP_SIZE),
+      hashes_(INITIAL_GROUPS * GROUP_SIZE) {
+    // sets initial values
+    size_ = 0;
+    groups_ = INITIAL_GROUPS;
+    reallocations_ = 0;
+    collisions_ = 0;
+    maximal_ = 0;
+}
+
+// range constructor
+template <typename T, typename Hash, typename KeyEqual>
+template <typename InputIt>
+SwissHashSet<T, Hash, KeyEqual>::SwissHashSet(InputIt first, InputIt last,
+                                              const Hash& hash,
+                                              const KeyEqual& equal)
+    : SwissHashSet(hash, equal) {
+    insert(first, last);
+}
+
+// returns size_ which is the number of elements
+template <typename T, typename Hash, typename KeyEqual>
+size_t SwissHashSet<T, Hash, KeyEqual>::size() const {
+    return size_;
+}
+
+// compares all 16 control bytes of a group at once when SSE2 is available
+template <typename T, typename Hash, typename KeyEqual>
+uint32_t SwissHashSet<T, Hash, KeyEqual>::match(const int8_t* group,
+                                                int8_t control) {
+#ifdef __SSE2__
+    __m128i bytes = _mm_loadu_si128(reinterpret_cast<const __m128i*>(group));
+    return _mm_movemask_epi8(_mm_cmpeq_epi8(bytes, _mm_set1_epi8(control)));
+#else
+    uint32_t bits = 0;
+    for (size_t i = 0; i < GROUP_SIZE; ++i) {
+        if (group[i] == control) {
+            bits |= uint32_t(1) << i;
+        }
+    }
+    return bits;
+#endif
+}
+
+// inserts an element into the hash table
+template <typename T, typename Hash, typename KeyEqual>
+void SwissHashSet<T, Hash, KeyEqual>::insert(const T& x) {
+    add(x);
+}
+
+// inserts an element, moving it in
+template <typename T, typename Hash, typename KeyEqual>
+void SwissHashSet<T, Hash, KeyEqual>::insert(T&& x) {
+    add(std::move(x));
+}
+
+// makes an element in place and moves it into the table
+template <typename T, typename Hash, typename KeyEqual>
+template <typename... Args>
+void SwissHashSet<T, Hash, KeyEqual>::emplace(Args&&... args) {
+    add(T(std::forward<Args>(args)...));
+}
+
+// does the work for insert and emplace, copying or moving x only if it
+// isn't already there
+template <typename T, typename Hash, typename KeyEqual>
+template <typename U>
+void SwissHashSet<T, Hash, KeyEqual>::add(U&& x) {
+    size_t hv = mixHash(hasher_(x));
+    if (lookup(x, hv)) {
+        return;
+    }
+    // grow before the table gets too full; there must always be an empty
+    // slot for lookups to stop at
+    if (static_cast<double>(size_ + 1) / buckets() > MAX_LOAD) {
+        ++reallocations_;
+        reallocate();
+    }
+    place(std::forward<U>(x), hv);
+    ++size_;
+}
+
+// inserts a range of elements, reserving room for them first if the range
+// can be measured
+template <typename T, typename Hash, typename KeyEqual>
+template <typename InputIt>
+void SwissHashSet<T, Hash, KeyEqual>::insert(InputIt first, InputIt last) {
+    using category = typename std::iterator_traits<InputIt>::iterator_category;
+    if constexpr (std::is_base_of_v<std::forward_iterator_tag, category>) {
+        reserve(size_ + std::distance(first, last));
+    }
+    for (; first != last; ++first) {
+        insert(*first);
+    }
+}
+
+// grows the table to fit n elements in one step
+template <typename T, typename Hash, typename KeyEqual>
+void SwissHashSet<T, Hash, KeyEqual>::reserve(size_t n) {
+    size_t wanted = groups_;
+    while (static_cast<double>(n) / (wanted * GROUP_SIZE) > MAX_LOAD) {
+        wanted *= 2;
+    }
+    if (wanted > groups_) {
+        // growing an empty table doesn't move anything, so it isn't counted
+        if (size_ != 0) {
+            ++reallocations_;
+        }
+        resize(wanted);
+    }
+}
+
+// puts x in the first empty slot, looking one group at a time starting
+// with its home group; hv is the mixed hash, whose low seven bits are the
+// fingerprint and whose other bits pick the group
+template <typename T, typename Hash, typename KeyEqual>
+void SwissHashSet<T, Hash, KeyEqual>::place(T x, size_t hv) {
+    size_t group = (hv >> 7) & (groups_ - 1);
+    for (size_t probe = 1; ; ++probe) {
+        const int8_t* control = &control_[group * GROUP_SIZE];
+        uint32_t empties = match(control, EMPTY);
+        if (probe == 1 && empties != (uint32_t(1) << GROUP_SIZE) - 1) {
+            ++collisions_;
+        }
+        if (empties != 0) {
+            size_t index = group * GROUP_SIZE + __builtin_ctz(empties);
+            control_[index] = int8_t(hv & 0x7f);
+            slots_[index] = std::move(x);
+            hashes_[index] = hv;
+            if (probe > maximal_) {
+                maximal_ = probe;
+            }
+            return;
+        }
+        group = (group + 1) & (groups_ - 1);
+    }
+}
+
+// reallocate - doubles the size of the hashtable
+template <typename T, typename Hash, typename KeyEqual>
+void SwissHashSet<T, Hash, KeyEqual>::reallocate() {
+    resize(groups_ * 2);
+}
+
+// moves every element into a new table, using the hashes stored with them
+template <typename T, typename Hash, typename KeyEqual>
+void SwissHashSet<T, Hash, KeyEqual>::resize(size_t groups) {
+    std::vector<int8_t> oldControl(groups * GROUP_SIZE, EMPTY);
+    std::vector<T> oldSlots(groups * GROUP_SIZE);
+    std::vector<size_t> oldHashes(groups * GROUP_SIZE);
+    std::swap(oldControl, control_);
+    std::swap(oldSlots, slots_);
+    std::swap(oldHashes, hashes_);
+    groups_ = groups;
+    collisions_ = 0;
+    maximal_ = 0;
+    for (size_t i = 0; i < oldSlots.size(); ++i) {
+        if (oldControl[i] != EMPTY) {
+            place(std::move(oldSlots[i]), oldHashes[i]);
+        }
+    }
+}
+
+// check if the element is already in the hash table
+template <typename T, typename Hash, typename KeyEqual>
+bool SwissHashSet<T, Hash, KeyEqual>::exists(const T& x) const {
+    return lookup(x, mixHash(hasher_(x)));
+}
+
+// check for a key of some other type
+template <typename T, typename Hash, typename KeyEqual>
+template <typename K, typename H, typename E, typename, typename>
+bool SwissHashSet<T, Hash, KeyEqual>::exists(const K& key) const {
+    return lookup(key, mixHash(hasher_(key)));
+}
+
+// only slots whose fingerprint matches are compared, and a group with an
+// empty slot ends the search
+template <typename T, typename Hash, typename KeyEqual>
+template <typename K>
+bool SwissHashSet<T, Hash, KeyEqual>::lookup(const K& key,
+                                             size_t hv) const {
+    int8_t fingerprint = int8_t(hv & 0x7f);
+    size_t group = (hv >> 7) & (groups_ - 1);
+    while (true) {
+        const int8_t* control = &control_[group * GROUP_SIZE];
+        for (uint32_t hits = match(control, fingerprint); hits != 0;
+             hits &= hits - 1) {
+            size_t index = group * GROUP_SIZE + __builtin_ctz(hits);
+            if (equal_(key, slots_[index])) {
+                return true;
+            }
+        }
+        if (match(control, EMPTY) != 0) {
+            return false;
+        }
+        group = (group + 1) & (groups_ - 1);
+    }
+}
+
+// return the number of slots in the table
+template <typename T, typename Hash, typename KeyEqual>
+size_t SwissHashSet<T, Hash, KeyEqual>::buckets() const {
+    return groups_ * GROUP_SIZE;
+}
+
+// return the the of times the hashtable has been resized
+template <typename T, typename Hash, typename KeyEqual>
+size_t SwissHashSet<T, Hash, KeyEqual>::reallocations() const {
+    return reallocations_;
+}
+
+// return the recorded number of collisions
+template <typename T, typename Hash, typename KeyEqual>
+size_t SwissHashSet<T, Hash, KeyEqual>::collisions() const {
+    return collisions_;
+}
+
+// return the longest probe sequence
+template <typename T, typename Hash, typename KeyEqual>
+size_t SwissHashSet<T, Hash, KeyEqual>::maximal() const {
+    return maximal_;
+}
+
+// displays the statistics of the hash table
+template <typename T, typename Hash, typename KeyEqual>
+std::ostream& SwissHashSet<T, Hash, KeyEqual>::showStatistics(
+    std::ostream& out) const {
+    out << "Statistics:" << std::endl;
+    out << "             Size: " << size() << std::endl;
+    out << "          Buckets: " << buckets() << std::endl;
+    out << "    Reallocations: " << reallocations() << std::endl;
+    out << "       Collisions: " << collisions() << std::endl;
+    out << "Max groups probed: " << maximal() << std::endl;
+    return out;
+}
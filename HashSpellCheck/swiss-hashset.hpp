@@ -0,0 +1,146 @@
+/**
+ * \file swiss-hashset.hpp
+ *
+ * \brief Provides SwissHashSet<T>, a set class template, using an
+ *        open-addressing hash table that checks 16 slots at a time
+ */
+
+#ifndef SWISS_HASHSET_HPP_INCLUDED
+#define SWISS_HASHSET_HPP_INCLUDED 1
+
+// Like HashSet<T>, the implementation lives in swiss-hashset-private.hpp,
+// which is included at the bottom of this file.
+//
+// The design follows Google's "Swiss table". Slots are arranged in groups
+// of 16, and alongside the slots there's an array of one-byte control
+// values: EMPTY for an empty slot, or the low seven bits of a full slot's
+// hash (its fingerprint). A lookup loads a whole group's control bytes
+// and, with SSE2, compares all 16 against the fingerprint it wants in a
+// couple of instructions. Only slots whose fingerprints match are compared
+// with operator==, so looking up a word that isn't there (a misspelling)
+// usually never touches a stored string at all. Each slot's full hash is
+// kept in a separate array, which only growing the table reads, so growing
+// never calls the hash function.
+
+#include <cstdint>
+#include <functional>
+#include <iostream>
+#include <vector>
+
+#include "hash-functors.hpp"
+#include "hash-mixing.hpp"
+
+// Hash is a function object that turns a T (or, for transparent lookup,
+// some other key type) into a size_t; by default it calls myhash. KeyEqual
+// is a function object that says whether two keys are equal.
+template <typename T, typename Hash = MyHash,
+          typename KeyEqual = std::equal_to<T>>
+class SwissHashSet{
+ public:
+    // Default Constructor and destructor
+    SwissHashSet();
+    explicit SwissHashSet(const Hash& hash, const KeyEqual& equal = KeyEqual());
+
+    // makes a set holding the elements from first to last
+    template <typename InputIt>
+    SwissHashSet(InputIt first, InputIt last, const Hash& hash = Hash(),
+                 const KeyEqual& equal = KeyEqual());
+    ~SwissHashSet() = default;
+    // No assignment operator or copy constructor
+    SwissHashSet(const SwissHashSet&) = delete;
+    SwissHashSet operator=(const SwissHashSet&) = delete;
+
+    // returns the number of items stored in the table
+    size_t size() const;
+
+    // inserts an element into the hash table. Does nothing if the insertee
+    // has already been inserted
+    void insert(const T&);
+
+    // inserts an element into the hash table, moving it in rather than
+    // copying it
+    void insert(T&& x);
+
+    // makes an element from args and moves it into the hash table
+    template <typename... Args>
+    void emplace(Args&&... args);
+
+    // inserts the elements from first to last. If the range can be measured
+    // without using it up (i.e., first is a forward iterator), makes room
+    // for all of it first
+    template <typename InputIt>
+    void insert(InputIt first, InputIt last);
+
+    // makes the table big enough that it won't need to grow until it holds
+    // more than n elements
+    void reserve(size_t n);
+
+    // resizes the hashtable
+    void reallocate();
+
+    // returns true if the element is present in the hash table
+    bool exists(const T&) const;
+
+    // looks up any key that Hash and KeyEqual can handle (e.g., a
+    // std::string_view or const char* in a set of std::string) without
+    // making a T from it. Only available when both are transparent (have an
+    // is_transparent member type), as for std::unordered_set.
+    template <typename K, typename H = Hash, typename E = KeyEqual,
+              typename = typename H::is_transparent,
+              typename = typename E::is_transparent>
+    bool exists(const K& key) const;
+
+    // returns the number of buckets (slots)
+    size_t buckets() const;
+
+    // returns the number of times the hash table has resized
+    size_t reallocations() const;
+
+    // returns the number of times an insert found its home group non-empty
+    size_t collisions() const;
+
+    // returns the longest probe sequence, in groups
+    size_t maximal() const;
+
+    // prints all the relevant statistics about the hash table
+    std::ostream& showStatistics(std::ostream& out) const;
+
+ private:
+    // private variables
+    static const size_t GROUP_SIZE = 16;
+    static const size_t INITIAL_GROUPS = 1;  // always a power of two
+    static constexpr int8_t EMPTY = -128;  // fingerprints are 0 to 127
+    const double MAX_LOAD = 0.875;
+
+    // bit i of the result is set if group[i] == control
+    static uint32_t match(const int8_t* group, int8_t control);
+
+    // true if key, whose mixed hash is hv, is in the set
+    template <typename K>
+    bool lookup(const K& key, size_t hv) const;
+
+    // inserts x, a const T& or a T&&, unless it's already there
+    template <typename U>
+    void add(U&& x);
+
+    // puts an element known not to be in the table into place
+    void place(T x, size_t hv);
+
+    // moves every element into a new table with the given number of groups
+    // (a power of two)
+    void resize(size_t groups);
+
+    size_t size_;           // number of elements
+    size_t groups_;         // number of groups of slots
+    size_t reallocations_;  // number of resizes
+    size_t collisions_;     // number of collsions
+    size_t maximal_;        // longest probe sequence
+    Hash hasher_;
+    KeyEqual equal_;
+    std::vector<int8_t> control_;  // EMPTY or fingerprint, for each slot
+    std::vector<T> slots_;
+    std::vector<size_t> hashes_;   // mixed hash of each full slot
+};
+#include "swiss-hashset-private.hpp"
+
+#endif